@@ -0,0 +1,534 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+/*************************************************************************************************/
+
+#ifndef STLAB_ALGORITHM_PARALLEL_HPP
+#define STLAB_ALGORITHM_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <stlab/concurrency/executor_base.hpp>
+#include <stlab/concurrency/future.hpp>
+#include <stlab/concurrency/immediate_executor.hpp>
+#include <stlab/concurrency/optional.hpp>
+#include <stlab/concurrency/task.hpp>
+
+/*************************************************************************************************/
+
+/*
+    Parallel algorithms on stlab executors. Each algorithm takes an executor and a random access
+    range, or a range of integers for parallel_for, and returns a future of its result. The
+    blocking_ variants return the result and run chunks on the calling thread while they wait.
+
+    The range is processed in chunks claimed from a shared counter by one task per hardware
+    thread, so no future is created per element. A claim takes a share of the remaining elements
+    that shrinks as the range is consumed, which keeps the number of claims low while idle tasks
+    can still take over the tail of a slow chunk.
+
+    If a function throws, the chunks not yet claimed are skipped and the first exception is
+    reported through the future, or rethrown by the blocking variant.
+*/
+
+/*************************************************************************************************/
+
+namespace stlab {
+
+/*************************************************************************************************/
+
+namespace detail {
+
+/*************************************************************************************************/
+
+inline std::size_t parallel_width() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/*
+    One invocation of a parallel algorithm, run as a sequence of phases. A phase runs a body over
+    the indices [0, n) in chunks, then calls its continuation on the thread that completes the
+    last chunk. The continuation either starts the next phase or finishes the job.
+*/
+
+class parallel_job : public std::enable_shared_from_this<parallel_job> {
+    using lock_t = std::unique_lock<std::mutex>;
+
+    struct phase {
+        const std::size_t _n;
+        const std::size_t _grain;
+        const std::size_t _divisor;
+        std::atomic<std::size_t> _next{0};
+        std::atomic<std::size_t> _done{0};
+        task<void(std::size_t, std::size_t)> _body;
+        task<void()> _then;
+
+        phase(std::size_t n,
+              std::size_t grain,
+              std::size_t divisor,
+              task<void(std::size_t, std::size_t)> body,
+              task<void()> then) :
+            _n(n), _grain(grain), _divisor(divisor), _body(std::move(body)),
+            _then(std::move(then)) {}
+    };
+
+    const executor_t _executor;
+    const std::size_t _width;
+    std::mutex _mutex;
+    std::condition_variable _ready;
+    std::shared_ptr<phase> _phase;
+    bool _finished{false};
+    std::exception_ptr _error;
+    task<void(std::exception_ptr)> _on_error;
+
+    static bool claim(phase& p, std::size_t& first, std::size_t& last) {
+        auto next = p._next.load(std::memory_order_relaxed);
+        do {
+            if (next == p._n) return false;
+            last = std::min(p._n, next + std::max(p._grain, (p._n - next) / p._divisor));
+        } while (!p._next.compare_exchange_weak(next, last, std::memory_order_relaxed));
+        first = next;
+        return true;
+    }
+
+    void complete(phase& p, std::size_t count) {
+        if (p._done.fetch_add(count, std::memory_order_acq_rel) + count != p._n) return;
+
+        bool failed;
+        {
+            lock_t lock{_mutex};
+            failed = static_cast<bool>(_error);
+        }
+        if (!failed) {
+            try {
+                return p._then();
+            } catch (...) {
+                lock_t lock{_mutex};
+                _error = std::current_exception();
+            }
+        }
+        finish();
+    }
+
+    // Runs chunks of p until none are left to claim.
+    void work(const std::shared_ptr<phase>& p) {
+        std::size_t first;
+        std::size_t last;
+        while (claim(*p, first, last)) {
+            auto count = last - first;
+            try {
+                p->_body(first, last);
+            } catch (...) {
+                {
+                    lock_t lock{_mutex};
+                    if (!_error) _error = std::current_exception();
+                }
+                count += p->_n - p->_next.exchange(p->_n);
+            }
+            complete(*p, count);
+        }
+    }
+
+public:
+    explicit parallel_job(executor_t executor) :
+        _executor(std::move(executor)), _width(parallel_width()) {}
+
+    // Called instead of finishing normally if a body threw.
+    void on_error(task<void(std::exception_ptr)> f) { _on_error = std::move(f); }
+
+    void loop(std::size_t n,
+              std::size_t grain,
+              task<void(std::size_t, std::size_t)> body,
+              task<void()> then) {
+        if (n == 0) return then();
+
+        grain = std::max<std::size_t>(grain, 1);
+        auto p = std::make_shared<phase>(n, grain, 2 * _width, std::move(body), std::move(then));
+        {
+            lock_t lock{_mutex};
+            _phase = p;
+        }
+        _ready.notify_all();
+
+        auto self = shared_from_this();
+        auto count = std::min(_width, (n + grain - 1) / grain);
+        for (std::size_t k = 0; k != count; ++k) {
+            _executor([_self = self, _p = p] { _self->work(_p); });
+        }
+    }
+
+    void finish() {
+        std::exception_ptr error;
+        task<void(std::exception_ptr)> on_error;
+        {
+            lock_t lock{_mutex};
+            _finished = true;
+            _phase.reset();
+            error = _error;
+            if (error) on_error = std::move(_on_error);
+        }
+        _ready.notify_all();
+        if (on_error) on_error(std::move(error));
+    }
+
+    // Runs chunks of the current phase until the job is finished, rethrows its exception.
+    void help() {
+        lock_t lock{_mutex};
+        while (!_finished) {
+            auto p = _phase;
+            lock.unlock();
+            if (p) work(p);
+            lock.lock();
+            _ready.wait(lock, [&] { return _finished || _phase != p; });
+        }
+        if (_error) std::rethrow_exception(_error);
+    }
+
+    std::size_t width() const { return _width; }
+};
+
+/*************************************************************************************************/
+
+// The smallest chunk worth a claim, the claimed share of the remaining range is usually larger.
+inline std::size_t parallel_grain(std::size_t n, std::size_t width) {
+    return std::max<std::size_t>(1, n / (64 * width));
+}
+
+template <class I>
+auto parallel_at(I first, std::size_t k, std::true_type) {
+    return first + static_cast<I>(k);
+}
+
+template <class I>
+decltype(auto) parallel_at(I first, std::size_t k, std::false_type) {
+    return first[static_cast<typename std::iterator_traits<I>::difference_type>(k)];
+}
+
+// The k-th integer or the reference to the k-th element of the range starting at first.
+template <class I>
+decltype(auto) parallel_at(I first, std::size_t k) {
+    return parallel_at(first, k, std::is_integral<I>());
+}
+
+template <class I>
+std::size_t parallel_distance(I first, I last) {
+    return static_cast<std::size_t>(last - first);
+}
+
+/*************************************************************************************************/
+
+template <class R>
+auto parallel_promise(parallel_job& job) {
+    auto p = package<R(R)>(immediate_executor, [](R x) { return x; });
+    job.on_error([_p = p.first](std::exception_ptr e) { _p.set_exception(std::move(e)); });
+    return p;
+}
+
+inline auto parallel_void_promise(parallel_job& job) {
+    auto p = package<void()>(immediate_executor, [] {});
+    job.on_error([_p = p.first](std::exception_ptr e) { _p.set_exception(std::move(e)); });
+    return p;
+}
+
+/*************************************************************************************************/
+
+template <class I, class F, class D>
+void parallel_for_start(parallel_job& job, I first, I last, F f, D done) {
+    auto n = parallel_distance(first, last);
+    job.loop(n, parallel_grain(n, job.width()),
+             [first, _f = std::move(f)](std::size_t a, std::size_t b) {
+                 for (; a != b; ++a)
+                     _f(parallel_at(first, a));
+             },
+             [&job, _done = std::move(done)]() mutable {
+                 _done();
+                 job.finish();
+             });
+}
+
+template <class I, class O, class F, class D>
+void parallel_transform_start(parallel_job& job, I first, I last, O out, F f, D done) {
+    auto n = parallel_distance(first, last);
+    job.loop(n, parallel_grain(n, job.width()),
+             [first, out, _f = std::move(f)](std::size_t a, std::size_t b) {
+                 for (; a != b; ++a)
+                     parallel_at(out, a) = _f(parallel_at(first, a));
+             },
+             [&job, out, n, _done = std::move(done)]() mutable {
+                 _done(out + static_cast<typename std::iterator_traits<O>::difference_type>(n));
+                 job.finish();
+             });
+}
+
+// Chunk results are combined in the order of the chunks, so op only needs to be associative.
+template <class I, class T, class Op, class D>
+void parallel_reduce_start(parallel_job& job, I first, I last, T init, Op op, D done) {
+    struct state {
+        std::mutex _mutex;
+        std::vector<std::pair<std::size_t, T>> _partial;
+    };
+    auto s = std::make_shared<state>();
+    auto n = parallel_distance(first, last);
+    auto shared_op = std::make_shared<Op>(std::move(op));
+
+    job.loop(n, parallel_grain(n, job.width()),
+             [first, s, shared_op](std::size_t a, std::size_t b) {
+                 T result = parallel_at(first, a);
+                 for (auto k = a + 1; k != b; ++k)
+                     result = (*shared_op)(std::move(result), parallel_at(first, k));
+                 std::unique_lock<std::mutex> lock{s->_mutex};
+                 s->_partial.emplace_back(a, std::move(result));
+             },
+             [&job, s, shared_op, _init = std::move(init), _done = std::move(done)]() mutable {
+                 std::sort(begin(s->_partial), end(s->_partial),
+                           [](const auto& x, const auto& y) { return x.first < y.first; });
+                 for (auto& e : s->_partial)
+                     _init = (*shared_op)(std::move(_init), std::move(e.second));
+                 _done(std::move(_init));
+                 job.finish();
+             });
+}
+
+/*
+    An inclusive scan in two phases over blocks of the range. The first phase reduces each
+    block, then the block sums are scanned sequentially, and the second phase scans each block
+    starting from the sum of the blocks before it.
+*/
+template <class I, class O, class T, class Op, class D>
+void parallel_scan_start(parallel_job& job, I first, I last, O out, T init, Op op, D done) {
+    auto n = parallel_distance(first, last);
+    if (n == 0) {
+        done(out);
+        return job.finish();
+    }
+    auto size = (n + 4 * job.width() - 1) / (4 * job.width());
+    auto blocks = (n + size - 1) / size;
+
+    struct state {
+        std::vector<T> _sums;
+        Op _op;
+        state(std::size_t blocks, const T& init, Op op) : _sums(blocks, init), _op(std::move(op)) {}
+    };
+    auto s = std::make_shared<state>(blocks + 1, init, std::move(op));
+
+    auto scan = [&job, first, out, n, size, s, _done = std::move(done)]() mutable {
+        for (std::size_t k = 1; k != s->_sums.size(); ++k)
+            s->_sums[k] = s->_op(s->_sums[k - 1], std::move(s->_sums[k]));
+
+        job.loop(s->_sums.size() - 1, 1,
+                 [first, out, n, size, s](std::size_t a, std::size_t b) {
+                     for (; a != b; ++a) {
+                         T sum = s->_sums[a];
+                         for (auto k = a * size, l = std::min(n, k + size); k < l; ++k) {
+                             sum = s->_op(std::move(sum), parallel_at(first, k));
+                             parallel_at(out, k) = sum;
+                         }
+                     }
+                 },
+                 [&job, out, n, _done = std::move(_done)]() mutable {
+                     _done(out + static_cast<typename std::iterator_traits<O>::difference_type>(n));
+                     job.finish();
+                 });
+    };
+
+    // _sums[b + 1] is the sum of block b, _sums[0] is init.
+    job.loop(blocks, 1,
+             [first, n, size, s](std::size_t a, std::size_t b) {
+                 for (; a != b; ++a) {
+                     auto k = a * size;
+                     auto l = std::min(n, k + size);
+                     T sum = parallel_at(first, k);
+                     for (++k; k != l; ++k)
+                         sum = s->_op(std::move(sum), parallel_at(first, k));
+                     s->_sums[a + 1] = std::move(sum);
+                 }
+             },
+             std::move(scan));
+}
+
+/*
+    A merge sort. The blocks of the range are sorted in parallel and then merged pairwise in
+    rounds, each round merging blocks twice as wide as the round before.
+*/
+template <class I, class Compare, class D>
+void parallel_sort_start(parallel_job& job, I first, I last, Compare compare, D done) {
+    using difference_t = typename std::iterator_traits<I>::difference_type;
+
+    struct state {
+        parallel_job& _job;
+        I _first;
+        std::size_t _n;
+        std::size_t _size;
+        std::size_t _blocks;
+        Compare _compare;
+        D _done;
+
+        I at(std::size_t k) const {
+            return _first + static_cast<difference_t>(std::min(_n, k));
+        }
+
+        static void merge(const std::shared_ptr<state>& s, std::size_t width) {
+            if (width >= s->_blocks) {
+                s->_done();
+                return s->_job.finish();
+            }
+            auto pairs = (s->_blocks + 2 * width - 1) / (2 * width);
+            s->_job.loop(pairs, 1,
+                         [s, width](std::size_t a, std::size_t b) {
+                             for (; a != b; ++a) {
+                                 auto k = a * 2 * width * s->_size;
+                                 std::inplace_merge(s->at(k), s->at(k + width * s->_size),
+                                                    s->at(k + 2 * width * s->_size),
+                                                    s->_compare);
+                             }
+                         },
+                         [s, width] { merge(s, 2 * width); });
+        }
+    };
+
+    /*
+        Two blocks per thread balance the load. More would add merge rounds, which touch every
+        element. Blocks hold at least 2048 elements so sorting a block outweighs scheduling it.
+    */
+    auto n = parallel_distance(first, last);
+    auto blocks = std::max<std::size_t>(1, std::min(n / 2048, 2 * job.width()));
+    auto size = (n + blocks - 1) / blocks;
+    auto s = std::make_shared<state>(
+        state{job, first, n, size, blocks, std::move(compare), std::move(done)});
+
+    job.loop(blocks, 1,
+             [s](std::size_t a, std::size_t b) {
+                 for (; a != b; ++a)
+                     std::sort(s->at(a * s->_size), s->at((a + 1) * s->_size), s->_compare);
+             },
+             [s] { state::merge(s, 1); });
+}
+
+/*************************************************************************************************/
+
+} // namespace detail
+
+/*************************************************************************************************/
+
+// Invokes f with each element of [first, last), or with each integer if I is integral.
+template <class E, class I, class F>
+future<void> parallel_for(E executor, I first, I last, F f) {
+    auto job = std::make_shared<detail::parallel_job>(std::move(executor));
+    auto p = detail::parallel_void_promise(*job);
+    detail::parallel_for_start(*job, first, last, std::move(f), [_p = std::move(p.first)] { _p(); });
+    return std::move(p.second);
+}
+
+template <class E, class I, class F>
+void blocking_parallel_for(E executor, I first, I last, F f) {
+    auto job = std::make_shared<detail::parallel_job>(std::move(executor));
+    detail::parallel_for_start(*job, first, last, std::move(f), [] {});
+    job->help();
+}
+
+/*************************************************************************************************/
+
+// Assigns f(x) for each element x of [first, last) to the corresponding element of out.
+template <class E, class I, class O, class F>
+future<O> parallel_transform(E executor, I first, I last, O out, F f) {
+    auto job = std::make_shared<detail::parallel_job>(std::move(executor));
+    auto p = detail::parallel_promise<O>(*job);
+    detail::parallel_transform_start(*job, first, last, out, std::move(f),
+                                     [_p = std::move(p.first)](O x) { _p(x); });
+    return std::move(p.second);
+}
+
+template <class E, class I, class O, class F>
+O blocking_parallel_transform(E executor, I first, I last, O out, F f) {
+    auto job = std::make_shared<detail::parallel_job>(std::move(executor));
+    detail::parallel_transform_start(*job, first, last, out, std::move(f), [](O) {});
+    job->help();
+    return out + (last - first);
+}
+
+/*************************************************************************************************/
+
+// Combines init and the elements of [first, last) with the associative operation op.
+template <class E, class I, class T, class Op = std::plus<>>
+future<T> parallel_reduce(E executor, I first, I last, T init, Op op = Op()) {
+    auto job = std::make_shared<detail::parallel_job>(std::move(executor));
+    auto p = detail::parallel_promise<T>(*job);
+    detail::parallel_reduce_start(*job, first, last, std::move(init), std::move(op),
+                                  [_p = std::move(p.first)](T x) { _p(std::move(x)); });
+    return std::move(p.second);
+}
+
+template <class E, class I, class T, class Op = std::plus<>>
+T blocking_parallel_reduce(E executor, I first, I last, T init, Op op = Op()) {
+    auto job = std::make_shared<detail::parallel_job>(std::move(executor));
+    optional<T> result;
+    detail::parallel_reduce_start(*job, first, last, std::move(init), std::move(op),
+                                  [&result](T x) { result = std::move(x); });
+    job->help();
+    return std::move(*result);
+}
+
+/*************************************************************************************************/
+
+/*
+    Writes the inclusive scan of [first, last) with the associative operation op, starting from
+    init, to out. out may be first.
+*/
+template <class E, class I, class O, class T, class Op = std::plus<>>
+future<O> parallel_scan(E executor, I first, I last, O out, T init, Op op = Op()) {
+    auto job = std::make_shared<detail::parallel_job>(std::move(executor));
+    auto p = detail::parallel_promise<O>(*job);
+    detail::parallel_scan_start(*job, first, last, out, std::move(init), std::move(op),
+                                [_p = std::move(p.first)](O x) { _p(x); });
+    return std::move(p.second);
+}
+
+template <class E, class I, class O, class T, class Op = std::plus<>>
+O blocking_parallel_scan(E executor, I first, I last, O out, T init, Op op = Op()) {
+    auto job = std::make_shared<detail::parallel_job>(std::move(executor));
+    detail::parallel_scan_start(*job, first, last, out, std::move(init), std::move(op), [](O) {});
+    job->help();
+    return out + (last - first);
+}
+
+/*************************************************************************************************/
+
+// Sorts [first, last) with compare. The sort is not stable.
+template <class E, class I, class Compare = std::less<>>
+future<void> parallel_sort(E executor, I first, I last, Compare compare = Compare()) {
+    auto job = std::make_shared<detail::parallel_job>(std::move(executor));
+    auto p = detail::parallel_void_promise(*job);
+    detail::parallel_sort_start(*job, first, last, std::move(compare),
+                                [_p = std::move(p.first)] { _p(); });
+    return std::move(p.second);
+}
+
+template <class E, class I, class Compare = std::less<>>
+void blocking_parallel_sort(E executor, I first, I last, Compare compare = Compare()) {
+    auto job = std::make_shared<detail::parallel_job>(std::move(executor));
+    detail::parallel_sort_start(*job, first, last, std::move(compare), [] {});
+    job->help();
+}
+
+/*************************************************************************************************/
+
+} // namespace stlab
+
+/*************************************************************************************************/
+
+#endif // STLAB_ALGORITHM_PARALLEL_HPP
+
+/*************************************************************************************************/
@@ -23,6 +23,7 @@
 
 #include <stlab/concurrency/executor_base.hpp>
 #include <stlab/concurrency/optional.hpp>
+#include <stlab/concurrency/trace.hpp>
 #include <stlab/concurrency/traits.hpp>
 #include <stlab/concurrency/tuple_algorithm.hpp>
 #include <stlab/concurrency/variant.hpp>
@@ -1135,6 +1136,7 @@ struct shared_process
     }
 
     void run() {
+        trace_origin_scope<process_t> origin;
         _executor([_p = make_weak_ptr(this->shared_from_this())] {
             auto p = _p.lock();
             if (p) p->template step<T>();
@@ -19,6 +19,12 @@
 #define STLAB_FEATURE_PRIVATE_THREAD_NAME_APPLE() 0
 #define STLAB_FEATURE_PRIVATE_THREAD_NAME_POSIX() 0
 
+#define STLAB_FEATURE_PRIVATE_THREAD_AFFINITY_LINUX() 0
+#define STLAB_FEATURE_PRIVATE_EPOLL() 0
+
+#define STLAB_FEATURE_PRIVATE_TASK_SYSTEM_STATISTICS() 0
+#define STLAB_FEATURE_PRIVATE_TASK_SYSTEM_TRACE() 0
+
 #define STLAB_FEATURE(X) (STLAB_FEATURE_PRIVATE_##X())
 
 /**************************************************************************************************/
@@ -64,6 +70,30 @@
 
 #endif
 
+#if defined(__linux__)
+
+#undef STLAB_FEATURE_PRIVATE_THREAD_AFFINITY_LINUX
+#define STLAB_FEATURE_PRIVATE_THREAD_AFFINITY_LINUX() 1
+
+#undef STLAB_FEATURE_PRIVATE_EPOLL
+#define STLAB_FEATURE_PRIVATE_EPOLL() 1
+
+#endif
+
+#if defined(STLAB_ENABLE_TASK_SYSTEM_STATISTICS)
+
+#undef STLAB_FEATURE_PRIVATE_TASK_SYSTEM_STATISTICS
+#define STLAB_FEATURE_PRIVATE_TASK_SYSTEM_STATISTICS() 1
+
+#endif
+
+#if defined(STLAB_ENABLE_TASK_SYSTEM_TRACE)
+
+#undef STLAB_FEATURE_PRIVATE_TASK_SYSTEM_TRACE
+#define STLAB_FEATURE_PRIVATE_TASK_SYSTEM_TRACE() 1
+
+#endif
+
 #if !defined(STLAB_CPP_VERSION_PRIVATE)
     #if __cplusplus == 201103L
         #define STLAB_CPP_VERSION_PRIVATE() 11
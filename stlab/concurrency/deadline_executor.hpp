@@ -0,0 +1,225 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+/**************************************************************************************************/
+
+#ifndef STLAB_CONCURRENCY_DEADLINE_EXECUTOR_HPP
+#define STLAB_CONCURRENCY_DEADLINE_EXECUTOR_HPP
+
+#include <stlab/concurrency/executor_base.hpp>
+#include <stlab/concurrency/task.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**************************************************************************************************/
+
+namespace stlab {
+
+/**************************************************************************************************/
+
+inline namespace v1 {
+
+/**************************************************************************************************/
+
+// What a deadline_scheduler does with a task that starts after its deadline.
+enum class deadline_policy {
+    run,     // run it anyway
+    drop,    // destroy it without running, the future of a dropped task reports broken_promise
+    fallback // pass it to the fallback executor
+};
+
+/**************************************************************************************************/
+
+namespace detail {
+
+/**************************************************************************************************/
+
+class deadline_queue {
+public:
+    using clock_type = std::chrono::steady_clock;
+
+private:
+    using lock_t = std::unique_lock<std::mutex>;
+
+    struct element_t {
+        clock_type::time_point _deadline;
+        std::uint64_t _sequence;
+        task<void()> _task;
+
+        // A heap with the earliest deadline, then the earliest submission, on top.
+        struct greater {
+            bool operator()(const element_t& a, const element_t& b) const {
+                return b._deadline < a._deadline ||
+                       (!(a._deadline < b._deadline) && b._sequence < a._sequence);
+            }
+        };
+    };
+
+    std::mutex _mutex;
+    std::vector<element_t> _q;
+    std::uint64_t _sequence{0};
+    std::atomic<std::size_t> _misses{0};
+
+    const executor_t _executor;
+    const deadline_policy _policy;
+    const executor_t _fallback;
+
+    bool pop(element_t& x) {
+        lock_t lock{_mutex};
+        if (_q.empty()) return false;
+        std::pop_heap(begin(_q), end(_q), element_t::greater());
+        x = std::move(_q.back());
+        _q.pop_back();
+        return true;
+    }
+
+public:
+    deadline_queue(executor_t executor, deadline_policy policy, executor_t fallback) :
+        _executor(std::move(executor)), _policy(policy), _fallback(std::move(fallback)) {
+        if (_policy == deadline_policy::fallback && !_fallback) {
+            throw std::invalid_argument("deadline_policy::fallback requires a fallback executor");
+        }
+    }
+
+    /*
+        Queues f and schedules a token on the executor. Whichever token runs first runs the task
+        with the earliest deadline, so the tasks are dispatched earliest deadline first no matter
+        in which order the executor runs the tokens.
+    */
+    static void push(const std::shared_ptr<deadline_queue>& self,
+                     clock_type::time_point deadline,
+                     task<void()> f) {
+        {
+            lock_t lock{self->_mutex};
+            self->_q.push_back(element_t{deadline, self->_sequence++, std::move(f)});
+            std::push_heap(begin(self->_q), end(self->_q), element_t::greater());
+        }
+        self->_executor([_self = self] { _self->run_next(); });
+    }
+
+    void run_next() {
+        element_t e;
+        if (!pop(e)) return;
+
+        if (e._deadline < clock_type::now()) {
+            ++_misses;
+            switch (_policy) {
+                case deadline_policy::run:
+                    break;
+                case deadline_policy::drop:
+                    return;
+                case deadline_policy::fallback:
+                    _fallback(std::move(e._task));
+                    return;
+            }
+        }
+        e._task();
+    }
+
+    std::size_t misses() const { return _misses.load(); }
+
+    std::size_t size() {
+        lock_t lock{_mutex};
+        return _q.size();
+    }
+};
+
+/**************************************************************************************************/
+
+// Schedules each task with a deadline. relative tasks get their deadline when they are scheduled.
+class deadline_executor_type {
+    std::shared_ptr<deadline_queue> _queue;
+    deadline_queue::clock_type::time_point _deadline;
+    deadline_queue::clock_type::duration _relative;
+    bool _is_relative;
+
+public:
+    using result_type = void;
+
+    deadline_executor_type(std::shared_ptr<deadline_queue> queue,
+                           deadline_queue::clock_type::time_point deadline) :
+        _queue(std::move(queue)), _deadline(deadline), _relative{}, _is_relative(false) {}
+
+    deadline_executor_type(std::shared_ptr<deadline_queue> queue,
+                           deadline_queue::clock_type::duration relative) :
+        _queue(std::move(queue)), _deadline{}, _relative(relative), _is_relative(true) {}
+
+    void operator()(task<void()> f) const {
+        deadline_queue::push(_queue,
+                             _is_relative ? deadline_queue::clock_type::now() + _relative :
+                                            _deadline,
+                             std::move(f));
+    }
+};
+
+/**************************************************************************************************/
+
+} // namespace detail
+
+/**************************************************************************************************/
+
+/*
+    Dispatches tasks to an executor earliest deadline first. at() and within() return executors
+    that can be passed to async() and future::then(). Tasks that start after their deadline are
+    counted by misses() and handled according to the deadline_policy. The constructor throws
+    std::invalid_argument for deadline_policy::fallback without a fallback executor.
+
+    A deadline_scheduler is a handle, copies share the same queue. The queue lives until the last
+    handle and the last scheduled task are gone.
+*/
+
+class deadline_scheduler {
+    std::shared_ptr<detail::deadline_queue> _queue;
+
+public:
+    using clock_type = detail::deadline_queue::clock_type;
+
+    explicit deadline_scheduler(executor_t executor,
+                                deadline_policy policy = deadline_policy::run,
+                                executor_t fallback = {}) :
+        _queue(std::make_shared<detail::deadline_queue>(
+            std::move(executor), policy, std::move(fallback))) {}
+
+    // An executor that schedules its tasks with the given deadline.
+    detail::deadline_executor_type at(clock_type::time_point deadline) const {
+        return {_queue, deadline};
+    }
+
+    // An executor that schedules its tasks with a deadline of d after they are scheduled.
+    template <typename Rep, typename Per>
+    detail::deadline_executor_type within(std::chrono::duration<Rep, Per> d) const {
+        return {_queue, std::chrono::duration_cast<clock_type::duration>(d)};
+    }
+
+    // The number of tasks that started after their deadline.
+    std::size_t misses() const { return _queue->misses(); }
+
+    // The number of tasks waiting to be dispatched.
+    std::size_t size() const { return _queue->size(); }
+};
+
+/**************************************************************************************************/
+
+} // namespace v1
+
+/**************************************************************************************************/
+
+} // namespace stlab
+
+/**************************************************************************************************/
+
+#endif // STLAB_CONCURRENCY_DEADLINE_EXECUTOR_HPP
+
+/**************************************************************************************************/
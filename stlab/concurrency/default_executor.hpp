@@ -11,6 +11,7 @@
 
 #include <stlab/concurrency/config.hpp>
 #include <stlab/concurrency/task.hpp>
+#include <stlab/concurrency/trace.hpp>
 
 #include <cassert>
 #include <chrono>
@@ -33,9 +34,20 @@
 #include <array>
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <string>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#if defined(_M_IX86) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
 #endif
 
 /**************************************************************************************************/
@@ -44,6 +56,12 @@
 #include <pthread.h>
 #endif
 
+#if STLAB_TASK_SYSTEM(PORTABLE) && STLAB_FEATURE(THREAD_AFFINITY_LINUX)
+#include <sched.h>
+
+#include <fstream>
+#endif
+
 /**************************************************************************************************/
 
 namespace stlab {
@@ -250,49 +268,178 @@ inline auto queue_size() {
 #endif
 }
 
+/*
+    When and with which priority a task was submitted, kept next to the task in the queues. The
+    time is in nanoseconds of the steady clock and is only taken when aging or statistics use it.
+*/
+
+struct submission {
+    std::int64_t _time{0};
+    unsigned _priority{0};
+
+    static std::int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    static submission make(unsigned priority, bool timed) {
+#if STLAB_FEATURE(TASK_SYSTEM_STATISTICS)
+        timed = true;
+#endif
+        return {timed ? now() : 0, priority};
+    }
+};
+
 class notification_queue {
     using lock_t = std::unique_lock<std::mutex>;
 
     struct element_t {
-        unsigned _priority;
+        std::int64_t _key;
+        submission _submission;
         task<void()> _task;
 
         template <class F>
-        element_t(F&& f, unsigned priority) : _priority{priority}, _task{std::forward<F>(f)} { }
+        element_t(F&& f, submission s, std::int64_t key) :
+            _key{key}, _submission{s}, _task{std::forward<F>(f)} { }
 
         struct greater {
             bool operator()(const element_t& a, const element_t& b) const {
-                return b._priority < a._priority;
+                return b._key < a._key;
             }
         };
     };
 
     std::vector<element_t> _q; // can't use priority queue because top() is const
+    std::int64_t _aging{0};
     bool _done{false};
+    unsigned _waiting{0};
+    bool _wake{false};
     std::mutex _mutex;
     std::condition_variable _ready;
 
+    /*
+        Tasks are ordered by key. Without aging the key is the priority. With aging it is the time
+        of submission plus priority * _aging, so a waiting task overtakes tasks of higher priority
+        submitted more than _aging per level after it, and tasks of equal priority run in order.
+    */
+    std::int64_t key(const submission& s) const {
+        return _aging ? s._time + s._priority * _aging : s._priority;
+    }
+
+    template <typename F>
+    void emplace(F&& f, submission s) {
+        _q.emplace_back(std::forward<F>(f), s, key(s));
+        std::push_heap(begin(_q), end(_q), element_t::greater());
+    }
+
     // This must be called under a lock with a non-empty _q
-    task<void()> pop_not_empty() {
+    task<void()> pop_not_empty(submission& s) {
         auto result = std::move(_q.front()._task);
+        s = _q.front()._submission;
         std::pop_heap(begin(_q), end(_q), element_t::greater());
         _q.pop_back();
         return result;
     }
 
 public:
-    bool try_pop(task<void()>& x) {
+    // Must be called before the queue is used, zero disables aging.
+    void set_aging(std::chrono::nanoseconds aging) { _aging = aging.count(); }
+
+    // The submission of a task pushed now, the time is only taken if aging or statistics use it.
+    submission stamp(unsigned priority) const { return submission::make(priority, _aging != 0); }
+
+    bool try_pop(task<void()>& x, submission& s) {
         lock_t lock{_mutex, std::try_to_lock};
         if (!lock || _q.empty()) return false;
-        x = pop_not_empty();
+        x = pop_not_empty(s);
+        return true;
+    }
+
+    // Any thread may pop from a notification_queue, so stealing is the same as popping.
+    bool try_steal(task<void()>& x, submission& s) { return try_pop(x, s); }
+
+    /*
+        Blocks until a task is available and returns true. Returns false once the queue is done
+        and empty. Returns true with an empty x if the waiting thread was woken by wake().
+    */
+    bool pop(task<void()>& x, submission& s) {
+        lock_t lock{_mutex};
+        ++_waiting;
+        while (_q.empty() && !_done && !_wake) _ready.wait(lock);
+        --_waiting;
+        _wake = false;
+        if (_q.empty()) return !_done;
+        x = pop_not_empty(s);
+        return true;
+    }
+
+    // Like pop(), but also returns true with an empty x once timeout has passed.
+    bool pop(task<void()>& x, submission& s, std::chrono::nanoseconds timeout) {
+        lock_t lock{_mutex};
+        ++_waiting;
+        _ready.wait_for(lock, timeout, [&] { return !_q.empty() || _done || _wake; });
+        --_waiting;
+        _wake = false;
+        if (_q.empty()) return !_done;
+        x = pop_not_empty(s);
         return true;
     }
 
-    bool pop(task<void()>& x) {
+    // Like pop(), but returns false with an empty x if no task arrives within timeout.
+    bool pop_for(task<void()>& x, std::chrono::nanoseconds timeout) {
         lock_t lock{_mutex};
-        while (_q.empty() && !_done) _ready.wait(lock);
+        ++_waiting;
+        _ready.wait_for(lock, timeout, [&] { return !_q.empty() || _done; });
+        --_waiting;
         if (_q.empty()) return false;
-        x = pop_not_empty();
+        submission s;
+        x = pop_not_empty(s);
+        return true;
+    }
+
+    // Wakes a thread blocked in pop() so it can steal work. Returns false if none is waiting.
+    bool wake() {
+        {
+            lock_t lock{_mutex, std::try_to_lock};
+            if (!lock || _waiting == 0 || _wake) return false;
+            _wake = true;
+        }
+        _ready.notify_one();
+        return true;
+    }
+
+    /*
+        Like wake(), but waits for the lock rather than giving up, and leaves the flag set if no
+        thread is waiting yet, so the next call to pop() returns without blocking.
+    */
+    void interrupt() {
+        {
+            lock_t lock{_mutex};
+            _wake = true;
+        }
+        _ready.notify_all();
+    }
+
+    // The number of queued tasks for each priority.
+    std::array<std::size_t, 3> depth() {
+        std::array<std::size_t, 3> result{};
+        lock_t lock{_mutex};
+        for (const auto& e : _q) ++result[e._submission._priority];
+        return result;
+    }
+
+    // Moves all queued tasks out with a single lock acquisition, calling `out(task, submission)`
+    // for each one after the lock has been released.
+    template <typename F>
+    bool try_drain(F out) {
+        std::vector<element_t> q;
+        {
+            lock_t lock{_mutex, std::try_to_lock};
+            if (!lock || _q.empty()) return false;
+            swap(q, _q);
+        }
+        for (auto& e : q) out(std::move(e._task), e._submission);
         return true;
     }
 
@@ -306,11 +453,11 @@ public:
 
     template <typename F>
     bool try_push(F&& f, unsigned priority) {
+        auto s = stamp(priority);
         {
             lock_t lock{_mutex, std::try_to_lock};
             if (!lock) return false;
-            _q.emplace_back(std::forward<F>(f), priority);
-            std::push_heap(begin(_q), end(_q), element_t::greater());
+            emplace(std::forward<F>(f), s);
         }
         _ready.notify_one();
         return true;
@@ -318,10 +465,29 @@ public:
 
     template <typename F>
     void push(F&& f, unsigned priority) {
+        auto s = stamp(priority);
+        {
+            lock_t lock{_mutex};
+            emplace(std::forward<F>(f), s);
+        }
+        _ready.notify_one();
+    }
+
+    // Called by the owning worker, which picks the task up itself, so nobody is notified.
+    template <typename F>
+    void push_local(F&& f, unsigned priority) {
+        auto s = stamp(priority);
+        lock_t lock{_mutex};
+        emplace(std::forward<F>(f), s);
+    }
+
+    // Moves the tasks in [first, last) into the queue with one lock acquisition and one wake-up.
+    template <typename I>
+    void push_n(I first, I last, unsigned priority) {
+        auto s = stamp(priority);
         {
             lock_t lock{_mutex};
-            _q.emplace_back(std::forward<F>(f), priority);
-            std::push_heap(begin(_q), end(_q), element_t::greater());
+            for (; first != last; ++first) emplace(std::move(*first), s);
         }
         _ready.notify_one();
     }
@@ -329,117 +495,1336 @@ public:
 
 /**************************************************************************************************/
 
-class priority_task_system {
-    using lock_t = std::unique_lock<std::mutex>;
+/*
+    A Chase-Lev work-stealing deque as described in "Correct and Efficient Work-Stealing for Weak
+    Memory Models" (Le, Pop, Cohen, Zappa Nardelli, 2013).
 
-    const unsigned _count{queue_size()};
+    Only the owning thread may call push() and pop(), which operate LIFO on the bottom of the
+    deque. Any thread may call steal(), which operates FIFO on the top of the deque. T must be
+    trivially copyable, typically a pointer.
 
-    std::vector<std::thread> _threads;
-    std::vector<notification_queue> _q{_count};
-    std::atomic<unsigned> _index{0};
-    std::atomic_bool _done{false};
+    The buffer grows as needed. Retired buffers are kept until the deque is destroyed because a
+    thief may still be reading from them.
+*/
 
-    void run(unsigned i) {
-        #if STLAB_FEATURE(THREAD_NAME_POSIX)
-        pthread_setname_np(pthread_self(), "cc.stlab.default_executor");
-        #elif STLAB_FEATURE(THREAD_NAME_APPLE)
-        pthread_setname_np("cc.stlab.default_executor");
-        #endif
-        while (true) {
-            task<void()> f;
+template <class T>
+class chase_lev_deque {
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
 
-            for (unsigned n = 0; n != _count; ++n) {
-                if (_q[(i + n) % _count].try_pop(f)) break;
-            }
-            if (!f && !_q[i].pop(f)) break;
+    using index_t = std::int64_t;
 
-            f();
-        }
+    struct array_t {
+        const index_t _mask;
+        std::unique_ptr<std::atomic<T>[]> _data{new std::atomic<T>[std::size_t(_mask + 1)]};
+
+        explicit array_t(index_t capacity) : _mask(capacity - 1) {}
+
+        index_t capacity() const { return _mask + 1; }
+        T get(index_t i) const { return _data[i & _mask].load(std::memory_order_relaxed); }
+        void put(index_t i, T x) { _data[i & _mask].store(x, std::memory_order_relaxed); }
+    };
+
+    // top and bottom are written by different threads, keep them on separate cache lines
+    std::atomic<index_t> _top{0};
+    char _pad0[64 - sizeof(std::atomic<index_t>)];
+    std::atomic<index_t> _bottom{0};
+    char _pad1[64 - sizeof(std::atomic<index_t>)];
+    std::atomic<array_t*> _array;
+    std::vector<std::unique_ptr<array_t>> _buffers; // owner only, the last one is current
+
+    array_t* grow(array_t* a, index_t top, index_t bottom) {
+        auto result = std::make_unique<array_t>(a->capacity() * 2);
+        for (auto i = top; i != bottom; ++i) result->put(i, a->get(i));
+        _buffers.push_back(std::move(result));
+        _array.store(_buffers.back().get(), std::memory_order_release);
+        return _buffers.back().get();
     }
 
 public:
-    priority_task_system() {
-        _threads.reserve(_count);
-        for (unsigned n = 0; n != _count; ++n) {
-            _threads.emplace_back([&, n]{ run(n); });
+    explicit chase_lev_deque(index_t capacity = 64) {
+        assert(capacity > 0 && (capacity & (capacity - 1)) == 0 && "capacity must be power of 2");
+        _buffers.push_back(std::make_unique<array_t>(capacity));
+        _array.store(_buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    chase_lev_deque(const chase_lev_deque&) = delete;
+    chase_lev_deque& operator=(const chase_lev_deque&) = delete;
+
+    bool empty() const {
+        return _bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed);
+    }
+
+    // Only an estimate while other threads push, pop, or steal.
+    std::size_t size() const {
+        auto n = _bottom.load(std::memory_order_relaxed) - _top.load(std::memory_order_relaxed);
+        return n > 0 ? static_cast<std::size_t>(n) : 0;
+    }
+
+    // The index of the oldest element, every element below it has been popped or stolen.
+    index_t top() const { return _top.load(std::memory_order_acquire); }
+
+    // Returns the index the element was stored at.
+    index_t push(T x) {
+        auto b = _bottom.load(std::memory_order_relaxed);
+        auto t = _top.load(std::memory_order_acquire);
+        auto a = _array.load(std::memory_order_relaxed);
+        if (b - t > a->capacity() - 1) a = grow(a, t, b);
+        a->put(b, x);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(b + 1, std::memory_order_relaxed);
+        return b;
+    }
+
+    bool pop(T& x) {
+        auto b = _bottom.load(std::memory_order_relaxed) - 1;
+        auto a = _array.load(std::memory_order_relaxed);
+        _bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto t = _top.load(std::memory_order_relaxed);
+
+        if (b < t) { // empty
+            _bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
         }
+
+        x = a->get(b);
+        if (t != b) return true;
+
+        // single last element, race against thieves
+        bool won = _top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                std::memory_order_relaxed);
+        _bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
     }
 
-    ~priority_task_system() {
-        for (auto& e : _q) e.done();
-        for (auto& e : _threads) e.join();
+    bool steal(T& x) {
+        auto t = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto b = _bottom.load(std::memory_order_acquire);
+        if (b <= t) return false;
+
+        auto a = _array.load(std::memory_order_acquire);
+        x = a->get(t);
+        return _top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                            std::memory_order_relaxed);
     }
+};
+
+/**************************************************************************************************/
 
+/*
+    A per-worker queue for the priority_task_system with one chase_lev_deque per priority.
 
+    Submissions from other threads land in a locked inbox (a notification_queue), which is also
+    where an idle worker waits. The owning worker drains the inbox into its deques with a single
+    lock acquisition and then pops LIFO without locking. Other workers steal FIFO from the deques,
+    highest priority first, and fall back to the inbox.
 
-    template <std::size_t P, typename F>
-    void execute(F&& f) {
-        static_assert(P < 3, "More than 3 priorities are not known!");
-        auto i = _index++;
+    With aging the owner also records the index and submission time of every task it pushes. It
+    cannot read the oldest entry itself, a thief may take and free it at any moment, so it finds
+    the oldest task still in a deque from its own record and promotes it by stealing from itself.
+*/
 
-        for (unsigned n = 0; n != _count; ++n) {
-            if (_q[(i + n) % _count].try_push(std::forward<F>(f), P)) return;
+class work_stealing_queue {
+    struct entry_t {
+        task<void()> _task;
+        submission _submission;
+    };
+
+    using deque_t = chase_lev_deque<entry_t*>;
+
+    std::array<deque_t, 3> _deque;
+    notification_queue _inbox;
+    std::int64_t _aging{0};
+    std::array<std::deque<std::pair<std::int64_t, std::int64_t>>, 3> _pushed; // owner only
+
+    static void take(entry_t* p, task<void()>& x, submission& s) {
+        std::unique_ptr<entry_t> owned{p};
+        x = std::move(owned->_task);
+        s = owned->_submission;
+    }
+
+    void push(entry_t* p) {
+        auto n = p->_submission._priority;
+        auto i = _deque[n].push(p);
+        if (_aging) _pushed[n].emplace_back(i, p->_submission._time);
+    }
+
+    /*
+        Promotes the oldest task of a lower priority once it has waited priority * _aging, the
+        same bound the inbox applies. Among several such tasks the one with the smallest key wins.
+    */
+    bool pop_aged(entry_t*& p) {
+        std::int64_t now = 0;
+        std::size_t oldest = 0;
+        std::int64_t oldest_key = 0;
+        for (std::size_t n = 1; n != _deque.size(); ++n) {
+            auto& pushed = _pushed[n];
+            auto top = _deque[n].top();
+            while (!pushed.empty() && pushed.front().first < top) pushed.pop_front();
+            if (pushed.empty()) continue;
+
+            if (!now) now = submission::now();
+            auto key = pushed.front().second + static_cast<std::int64_t>(n) * _aging;
+            if (key <= now && (!oldest || key < oldest_key)) {
+                oldest = n;
+                oldest_key = key;
+            }
         }
+        // A thief may take the oldest task first, then it has been served anyway.
+        if (!oldest || !_deque[oldest].steal(p)) return false;
+        _pushed[oldest].pop_front();
+        return true;
+    }
 
-        _q[i % _count].push(std::forward<F>(f), P);
+    bool pop_local(task<void()>& x, submission& s) {
+        entry_t* p;
+        if (_aging && pop_aged(p)) {
+            take(p, x, s);
+            return true;
+        }
+        for (std::size_t n = 0; n != _deque.size(); ++n) {
+            if (_deque[n].pop(p)) {
+                if (_aging && !_pushed[n].empty()) _pushed[n].pop_back();
+                take(p, x, s);
+                return true;
+            }
+        }
+        return false;
     }
 
-    bool steal() {
+public:
+    work_stealing_queue() = default;
+
+    // Must be called before the queue is used, zero disables aging.
+    void set_aging(std::chrono::nanoseconds aging) {
+        _aging = aging.count();
+        _inbox.set_aging(aging);
+    }
+
+    ~work_stealing_queue() {
         task<void()> f;
+        submission s;
+        while (pop_local(f, s)) {}
+    }
 
-        for (unsigned n = 0; n != _count; ++n) {
-            if (_q[n].try_pop(f)) break;
+    // owner only
+    bool try_pop(task<void()>& x, submission& s) {
+        if (pop_local(x, s)) return true;
+        if (!_inbox.try_drain([&](task<void()>&& f, submission d) {
+                push(new entry_t{std::move(f), d});
+            }))
+            return false;
+        return pop_local(x, s);
+    }
+
+    bool try_steal(task<void()>& x, submission& s) {
+        entry_t* p;
+        for (auto& e : _deque) {
+            if (e.steal(p)) {
+                take(p, x, s);
+                return true;
+            }
         }
-        if (!f) return false;
+        return _inbox.try_pop(x, s);
+    }
 
-        f();
+    bool pop(task<void()>& x, submission& s) { return _inbox.pop(x, s); }
 
-        return true;
+    bool pop(task<void()>& x, submission& s, std::chrono::nanoseconds timeout) {
+        return _inbox.pop(x, s, timeout);
+    }
+
+    bool wake() { return _inbox.wake(); }
+
+    void interrupt() { _inbox.interrupt(); }
+
+    std::array<std::size_t, 3> depth() {
+        auto result = _inbox.depth();
+        for (std::size_t n = 0; n != _deque.size(); ++n) result[n] += _deque[n].size();
+        return result;
+    }
+
+    void done() { _inbox.done(); }
+
+    template <typename F>
+    bool try_push(F&& f, unsigned priority) {
+        return _inbox.try_push(std::forward<F>(f), priority);
+    }
+
+    template <typename F>
+    void push(F&& f, unsigned priority) {
+        _inbox.push(std::forward<F>(f), priority);
+    }
+
+    template <typename I>
+    void push_n(I first, I last, unsigned priority) {
+        _inbox.push_n(first, last, priority);
+    }
+
+    // owner only
+    template <typename F>
+    void push_local(F&& f, unsigned priority) {
+        push(new entry_t{std::forward<F>(f), _inbox.stamp(priority)});
     }
 };
 
-inline priority_task_system& pts() {
-    static priority_task_system only_task_system;
-    return only_task_system;
+/**************************************************************************************************/
+
+/*
+    Implemented by a task system that can compensate for a thread that blocks while serving
+    queue i, see blocking_guard.
+*/
+
+class managed_blocking {
+public:
+    virtual void begin_blocking(unsigned i) = 0;
+    virtual void end_blocking(unsigned i) = 0;
+
+protected:
+    ~managed_blocking() = default;
+};
+
+/*
+    Identifies the task system and queue index served by the current thread. Threads that are not
+    workers of any task system have a null _system. _blocking is also set for the compensating
+    threads of a task system, which are not workers and have a null _system.
+*/
+
+struct worker_identity {
+    const void* _system{nullptr};
+    unsigned _index{0};
+    managed_blocking* _blocking{nullptr};
+};
+
+inline worker_identity& this_worker() {
+    thread_local worker_identity result;
+    return result;
 }
 
-template <executor_priority P = executor_priority::medium>
-struct task_system
-{
-    using result_type = void;
+/**************************************************************************************************/
 
-    void operator()(task<void()> f) const {
-        pts().execute<static_cast<std::size_t>(P)>(std::move(f));
+} // namespace detail
+
+/**************************************************************************************************/
+
+/*
+    Where tasks submitted from a worker thread are placed. round_robin spreads them across all
+    queues like submissions from any other thread. worker_local pushes them onto the submitting
+    worker's own queue, where the submitter picks them up next and idle workers can steal them.
+*/
+
+enum class task_placement { round_robin, worker_local };
+
+/*
+    How a worker waits when it finds no task. It first re-checks the queues _spin times with a
+    pause instruction between attempts, then _yield times with a yield between attempts, and then
+    parks on its queue until it is notified. Spinning trades CPU time for a lower hand-off latency
+    because a spinning worker picks up new work without a futex wake.
+*/
+
+struct idle_policy {
+    unsigned _spin{0};
+    unsigned _yield{0};
+
+    // Park immediately, the behavior of the default executors.
+    static constexpr idle_policy park() { return {0, 0}; }
+
+    static constexpr idle_policy adaptive(unsigned spin = 1024, unsigned yield = 16) {
+        return {spin, yield};
     }
 };
 
-#endif
+/*
+    Which CPUs the workers of a task system may run on. none leaves the placement to the OS. cpu
+    pins each worker to a single CPU and numa_node restricts each worker to the CPUs of one NUMA
+    node. In both cases the workers are spread evenly across the nodes and an idle worker steals
+    from the queues of its own node before it steals from remote ones. Affinity is only supported
+    on Linux and ignored elsewhere.
+*/
 
-/**************************************************************************************************/
+enum class thread_affinity { none, cpu, numa_node };
 
-#if STLAB_TASK_SYSTEM(WINDOWS) || STLAB_TASK_SYSTEM(PORTABLE)
+/*
+    The configuration of a priority_task_system. _name is applied to the worker threads where the
+    platform supports it, POSIX truncates it to 15 characters.
+
+    _aging bounds the starvation of lower priorities under sustained load. A task ranks as if it
+    had been submitted _aging earlier for each priority level above it, so a low priority task
+    waits at most about 2 * _aging behind a stream of high priority tasks. Zero keeps the strict
+    priority order.
+
+    The hooks let clients set up and tear down per-thread resources such as allocator caches or
+    profiler registrations. _on_thread_start is called on each worker and compensating thread,
+    see blocking_guard, before it runs a task, and _on_thread_stop once it has run its last one.
+    _on_idle is called each time a thread is about to park, which makes it a place to flush
+    per-thread buffers. Each hook gets the index of the queue the thread serves, hooks may be
+    called concurrently from different threads and must not throw.
+*/
 
-template <executor_priority P = executor_priority::medium>
-struct executor_type {
-    using result_type = void;
+struct task_system_options {
+    unsigned _count{detail::queue_size()};
+    std::string _name{"cc.stlab.default_executor"};
+    task_placement _placement{task_placement::round_robin};
+    idle_policy _idle{idle_policy::park()};
+    thread_affinity _affinity{thread_affinity::none};
+    std::chrono::nanoseconds _aging{0};
+    std::function<void(unsigned)> _on_thread_start{};
+    std::function<void(unsigned)> _on_thread_stop{};
+    std::function<void(unsigned)> _on_idle{};
+};
 
-    void operator()(task<void()> f) const {
-        static task_system<P> only_task_system;
-        only_task_system(std::move(f));
+/*
+    The configuration of an elastic_task_system, the pool behind io_executor. It runs at most
+    _max threads and ends a thread once it has been idle for _idle_timeout.
+*/
+
+struct elastic_task_system_options {
+    unsigned _max{256};
+    std::chrono::nanoseconds _idle_timeout{std::chrono::seconds(10)};
+    std::string _name{"cc.stlab.io_executor"};
+};
+
+#if STLAB_FEATURE(TASK_SYSTEM_STATISTICS)
+
+/*
+    A snapshot of the activity of one worker of a priority_task_system. Counters are cumulative
+    since the task system was constructed. Tasks run by a compensating thread, see blocking_guard,
+    are counted for the worker it stands in for. Define STLAB_ENABLE_TASK_SYSTEM_STATISTICS to
+    collect them.
+*/
+
+struct worker_statistics {
+    std::uint64_t _executed{0};
+    std::uint64_t _steals{0};        // tasks taken from another worker's queue
+    std::uint64_t _failed_steals{0}; // attempts to steal that found nothing or lost a race
+    std::uint64_t _failed_pushes{0}; // try_push calls on this worker's queue that were refused
+    std::chrono::nanoseconds _parked{0};
+    std::chrono::nanoseconds _running{0};
+    std::array<std::size_t, 3> _depth{}; // queued tasks indexed by high, medium, and low priority
+};
+
+/*
+    A histogram of durations in the style of an HDR histogram. Durations below 16ns are counted
+    exactly, larger ones in 16 buckets per power of two, so a reported value is at most 1/16 above
+    the recorded one.
+*/
+
+class latency_histogram {
+    std::vector<std::uint64_t> _counts = std::vector<std::uint64_t>(size());
+
+public:
+    // The number of buckets.
+    static constexpr std::size_t size() { return 60 * 16; }
+
+    static std::size_t bucket(std::chrono::nanoseconds d) {
+        auto v = static_cast<std::uint64_t>(std::max<std::int64_t>(0, d.count()));
+        if (v < 16) return static_cast<std::size_t>(v);
+        std::size_t e = 4;
+        while (v >> (e + 1)) ++e;
+        return (e - 3) * 16 + static_cast<std::size_t>((v >> (e - 4)) & 15);
+    }
+
+    // The largest duration counted in bucket b.
+    static std::chrono::nanoseconds upper_bound(std::size_t b) {
+        if (b < 16) return std::chrono::nanoseconds(b);
+        auto e = b / 16 + 3;
+        auto lower = (16 + b % 16) << (e - 4);
+        return std::chrono::nanoseconds(lower + (std::uint64_t{1} << (e - 4)) - 1);
+    }
+
+    latency_histogram() = default;
+    explicit latency_histogram(std::vector<std::uint64_t> counts) : _counts(std::move(counts)) {}
+
+    void record(std::chrono::nanoseconds d) { ++_counts[bucket(d)]; }
+
+    std::uint64_t count() const {
+        std::uint64_t result = 0;
+        for (auto e : _counts) result += e;
+        return result;
+    }
+
+    // The smallest bucket bound not exceeded by the fraction p, in [0, 1], of the durations.
+    std::chrono::nanoseconds percentile(double p) const {
+        auto total = count();
+        if (total == 0) return std::chrono::nanoseconds{0};
+        auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(p * total + 0.5));
+        std::uint64_t seen = 0;
+        for (std::size_t b = 0; b != _counts.size(); ++b) {
+            seen += _counts[b];
+            if (rank <= seen) return upper_bound(b);
+        }
+        return upper_bound(_counts.size() - 1);
     }
+
+    const std::vector<std::uint64_t>& counts() const { return _counts; }
 };
 
 #endif
 
 /**************************************************************************************************/
 
-} // namespace detail
+namespace detail {
 
 /**************************************************************************************************/
 
-constexpr auto low_executor = detail::executor_type<detail::executor_priority::low>{};
-constexpr auto default_executor = detail::executor_type<detail::executor_priority::medium>{};
-constexpr auto high_executor = detail::executor_type<detail::executor_priority::high>{};
+#if STLAB_FEATURE(TASK_SYSTEM_STATISTICS)
+
+/*
+    The counters behind worker_statistics. A worker's counters are mostly written by its own
+    thread, so they use relaxed atomics and each worker's counters get a cache line of their own.
+*/
+
+class alignas(64) worker_counters {
+    using clock_type = std::chrono::steady_clock;
+
+    std::atomic<std::uint64_t> _executed{0};
+    std::atomic<std::uint64_t> _steals{0};
+    std::atomic<std::uint64_t> _failed_steals{0};
+    std::atomic<std::uint64_t> _failed_pushes{0};
+    std::atomic<std::int64_t> _parked{0};
+    std::atomic<std::int64_t> _running{0};
+
+    static void add(std::atomic<std::int64_t>& x, clock_type::time_point since) {
+        auto d = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - since);
+        x.fetch_add(d.count(), std::memory_order_relaxed);
+    }
+
+public:
+    using stamp_t = clock_type::time_point;
+
+    static stamp_t now() { return clock_type::now(); }
+
+    void executed(stamp_t since) {
+        _executed.fetch_add(1, std::memory_order_relaxed);
+        add(_running, since);
+    }
+    void parked(stamp_t since) { add(_parked, since); }
+    void stolen(bool success) {
+        (success ? _steals : _failed_steals).fetch_add(1, std::memory_order_relaxed);
+    }
+    void push_failed() { _failed_pushes.fetch_add(1, std::memory_order_relaxed); }
+
+    worker_statistics get() const {
+        worker_statistics result;
+        result._executed = _executed.load(std::memory_order_relaxed);
+        result._steals = _steals.load(std::memory_order_relaxed);
+        result._failed_steals = _failed_steals.load(std::memory_order_relaxed);
+        result._failed_pushes = _failed_pushes.load(std::memory_order_relaxed);
+        result._parked = std::chrono::nanoseconds{_parked.load(std::memory_order_relaxed)};
+        result._running = std::chrono::nanoseconds{_running.load(std::memory_order_relaxed)};
+        return result;
+    }
+};
+
+using worker_counters_t = std::vector<worker_counters>;
+
+/*
+    Records the time from submission until a task starts, the queueing delay, for each priority.
+    The queues keep the submission next to each task, so tasks are not wrapped.
+*/
+
+class queue_delay_recorder {
+    using counts_t = std::array<std::atomic<std::uint64_t>, latency_histogram::size()>;
+
+    std::array<counts_t, 3> _counts{};
+
+public:
+    void record(const submission& s) {
+        auto d = std::chrono::nanoseconds{submission::now() - s._time};
+        _counts[s._priority][latency_histogram::bucket(d)].fetch_add(1,
+                                                                     std::memory_order_relaxed);
+    }
+
+    std::array<latency_histogram, 3> get(bool reset) {
+        std::array<latency_histogram, 3> result;
+        for (std::size_t p = 0; p != _counts.size(); ++p) {
+            std::vector<std::uint64_t> counts(latency_histogram::size());
+            for (std::size_t b = 0; b != counts.size(); ++b) {
+                counts[b] = reset ? _counts[p][b].exchange(0, std::memory_order_relaxed) :
+                                    _counts[p][b].load(std::memory_order_relaxed);
+            }
+            result[p] = latency_histogram(std::move(counts));
+        }
+        return result;
+    }
+};
+
+#else
+
+// Without statistics the counters have no state and every call compiles to nothing.
+
+struct worker_counters {
+    struct stamp_t {};
+
+    static stamp_t now() { return {}; }
+
+    void executed(stamp_t) {}
+    void parked(stamp_t) {}
+    void stolen(bool) {}
+    void push_failed() {}
+};
+
+struct worker_counters_t {
+    explicit worker_counters_t(std::size_t) {}
+    worker_counters operator[](std::size_t) const { return {}; }
+};
+
+struct queue_delay_recorder {
+    void record(const submission&) {}
+};
+
+#endif
+
+/**************************************************************************************************/
+
+inline void cpu_relax() {
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#elif defined(_M_IX86) || defined(_M_X64)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+#if STLAB_FEATURE(THREAD_AFFINITY_LINUX)
+
+// Reads a Linux CPU or node list of the form "0-3,8,10-11".
+inline std::vector<int> read_cpu_list(const std::string& path) {
+    std::vector<int> result;
+    std::ifstream in(path);
+    int first = 0;
+    while (in >> first) {
+        int last = first;
+        if (in.peek() == '-') {
+            in.ignore();
+            in >> last;
+        }
+        for (int n = first; n <= last; ++n) result.push_back(n);
+        if (in.peek() == ',') in.ignore();
+    }
+    return result;
+}
+
+#endif
+
+/*
+    Returns the CPUs this process may run on, grouped by NUMA node. Nodes without any such CPU are
+    omitted. If the node topology is unknown all CPUs form a single node, and if affinity is not
+    supported the result is empty.
+*/
+inline std::vector<std::vector<int>> cpu_topology() {
+    std::vector<std::vector<int>> result;
+
+#if STLAB_FEATURE(THREAD_AFFINITY_LINUX)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return result;
+
+    auto is_allowed = [&](int cpu) {
+        return 0 <= cpu && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed);
+    };
+
+    for (auto node : read_cpu_list("/sys/devices/system/node/online")) {
+        auto cpus = read_cpu_list("/sys/devices/system/node/node" + std::to_string(node) +
+                                  "/cpulist");
+        cpus.erase(std::remove_if(cpus.begin(), cpus.end(),
+                                  [&](int cpu) { return !is_allowed(cpu); }),
+                   cpus.end());
+        if (!cpus.empty()) result.push_back(std::move(cpus));
+    }
+
+    if (result.empty()) {
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu != CPU_SETSIZE; ++cpu) {
+            if (is_allowed(cpu)) cpus.push_back(cpu);
+        }
+        if (!cpus.empty()) result.push_back(std::move(cpus));
+    }
+#endif
+
+    return result;
+}
+
+inline void set_thread_affinity(const std::vector<int>& cpus) {
+#if STLAB_FEATURE(THREAD_AFFINITY_LINUX)
+    if (cpus.empty()) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : cpus) CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void)cpus;
+#endif
+}
+
+/**************************************************************************************************/
+
+template <class Queue>
+class priority_task_system;
+
+/*
+    An executor that schedules tasks with priority P on a priority_task_system instance. The task
+    system must outlive all tasks scheduled through the executor.
+*/
+
+template <class Queue, executor_priority P>
+class task_system_executor {
+    priority_task_system<Queue>* _system;
+
+public:
+    using result_type = void;
+
+    explicit task_system_executor(priority_task_system<Queue>& system) : _system(&system) {}
+
+    void operator()(task<void()> f) const {
+        _system->template execute<static_cast<std::size_t>(P)>(std::move(f));
+    }
+
+    // Submits the range of task<void()> in [first, last) as a batch, see bulk_execute().
+    template <typename I>
+    void bulk(I first, I last) const {
+        _system->template execute_n<static_cast<std::size_t>(P)>(first, last);
+    }
+
+    friend bool operator==(const task_system_executor& x, const task_system_executor& y) {
+        return x._system == y._system;
+    }
+    friend bool operator!=(const task_system_executor& x, const task_system_executor& y) {
+        return !(x == y);
+    }
+};
+
+/*
+    The portable task system. Queue selects the per-worker queue: notification_queue (the default)
+    or work_stealing_queue. Define STLAB_FORCE_WORK_STEALING_QUEUE to use the latter, with
+    worker_local placement, for the default, low, and high executors.
+*/
+
+template <class Queue = notification_queue>
+class priority_task_system : private managed_blocking {
+    using lock_t = std::unique_lock<std::mutex>;
+
+    const unsigned _count;
+    const std::string _name;
+
+    std::vector<std::thread> _threads;
+    std::vector<Queue> _q;
+    std::atomic<unsigned> _index{0};
+    std::atomic<unsigned> _idle{0};
+    std::atomic_bool _done{false};
+    const task_placement _placement;
+    const idle_policy _idle_policy;
+    const std::function<void(unsigned)> _on_thread_start;
+    const std::function<void(unsigned)> _on_thread_stop;
+    const std::function<void(unsigned)> _on_idle;
+
+    // For each worker the other queues in the order it steals from them.
+    std::vector<std::vector<unsigned>> _steal_order;
+
+    // Per queue, the number of blocked threads and of threads compensating for them.
+    std::vector<std::atomic<unsigned>> _blocked;
+    std::vector<std::atomic<unsigned>> _compensating;
+    std::mutex _compensator_mutex;
+    std::condition_variable _compensator_ready;
+    std::vector<std::thread> _compensators;
+    unsigned _parked{0};             // retired compensating threads waiting to be reused
+    std::vector<unsigned> _handoff;  // queues assigned to parked threads that have not woken yet
+
+    worker_counters_t _counters;
+    queue_delay_recorder _queue_delay;
+
+    bool try_get(unsigned i, task<void()>& f, submission& s) {
+        if (_q[i].try_pop(f, s)) return true;
+        for (auto n : _steal_order[i]) {
+            bool stolen = _q[n].try_steal(f, s);
+            _counters[i].stolen(stolen);
+            if (stolen) return true;
+        }
+        return false;
+    }
+
+    // Returns false once the task system is done. f is left empty if the worker was woken to steal.
+    bool wait(unsigned i, task<void()>& f, submission& s) {
+        for (unsigned n = 0; n != _idle_policy._spin; ++n) {
+            cpu_relax();
+            if (try_get(i, f, s)) return true;
+        }
+        for (unsigned n = 0; n != _idle_policy._yield; ++n) {
+            std::this_thread::yield();
+            if (try_get(i, f, s)) return true;
+        }
+
+        if (_on_idle) _on_idle(i);
+        ++_idle;
+        auto start = _counters[i].now();
+        bool running = _q[i].pop(f, s);
+        _counters[i].parked(start);
+        --_idle;
+        return running;
+    }
+
+    void set_thread_name() const {
+        #if STLAB_FEATURE(THREAD_NAME_POSIX)
+        // Linux rejects names longer than 15 characters.
+        pthread_setname_np(pthread_self(), _name.substr(0, 15).c_str());
+        #elif STLAB_FEATURE(THREAD_NAME_APPLE)
+        pthread_setname_np(_name.c_str());
+        #endif
+    }
+
+    void run(unsigned i, const std::vector<int>& cpus) {
+        set_thread_affinity(cpus);
+        set_thread_name();
+#if STLAB_FEATURE(TASK_SYSTEM_TRACE)
+        this_trace_thread_name() = _name + " " + std::to_string(i);
+#endif
+        this_worker() = worker_identity{this, i, this};
+        if (_on_thread_start) _on_thread_start(i);
+
+        while (true) {
+            task<void()> f;
+            submission s;
+
+            if (!try_get(i, f, s) && !wait(i, f, s)) break;
+            if (f) {
+                _queue_delay.record(s);
+                auto start = _counters[i].now();
+                f();
+                _counters[i].executed(start);
+            }
+        }
+
+        if (_on_thread_stop) _on_thread_stop(i);
+    }
+
+    /*
+        A compensating thread serves queue i while a thread serving it is blocked. It only steals,
+        so it never touches the owner's end of a work_stealing_queue, and it parks on queue i.
+        It retires once there are more compensating threads than blocked ones, which it notices
+        when it is woken by end_blocking() or by the next task. Another thread may consume the
+        wake-up, so it also checks every compensation_poll while parked. A retired thread waits
+        to be reused by the next begin_blocking() until the task system is destroyed. A
+        compensating thread inherits the affinity of the blocked thread that created it.
+    */
+    void compensate(unsigned i) {
+        set_thread_name();
+#if STLAB_FEATURE(TASK_SYSTEM_TRACE)
+        this_trace_thread_name() = _name + " (compensating)";
+#endif
+        this_worker() = worker_identity{nullptr, i, this};
+        if (_on_thread_start) _on_thread_start(i);
+
+        while (serve(i) && reuse(i)) {}
+
+        if (_on_thread_stop) _on_thread_stop(i);
+    }
+
+    // Returns true once the thread retires, false once the task system is done.
+    bool serve(unsigned i) {
+        while (!retire(i)) {
+            task<void()> f;
+            submission s;
+
+            if (!try_steal(i, f, s)) {
+                if (_on_idle) _on_idle(i);
+                auto start = _counters[i].now();
+                if (!_q[i].pop(f, s, compensation_poll())) return false;
+                _counters[i].parked(start);
+            }
+            if (f) {
+                _queue_delay.record(s);
+                auto start = _counters[i].now();
+                f();
+                _counters[i].executed(start);
+            }
+        }
+        return true;
+    }
+
+    // Waits for the next queue to serve and returns true, or false once the task system is done.
+    bool reuse(unsigned& i) {
+        lock_t lock{_compensator_mutex};
+        ++_parked;
+        _compensator_ready.wait(lock, [&] { return !_handoff.empty() || _done; });
+        --_parked;
+        if (_handoff.empty()) return false;
+        i = _handoff.back();
+        _handoff.pop_back();
+        this_worker()._index = i;
+        return true;
+    }
+
+    bool try_steal(unsigned i, task<void()>& f, submission& s) {
+        if (_q[i].try_steal(f, s)) return true;
+        for (auto n : _steal_order[i]) {
+            bool stolen = _q[n].try_steal(f, s);
+            _counters[i].stolen(stolen);
+            if (stolen) return true;
+        }
+        return false;
+    }
+
+    static constexpr std::chrono::milliseconds compensation_poll() {
+        return std::chrono::milliseconds(10);
+    }
+
+    bool retire(unsigned i) {
+        auto n = _compensating[i].load();
+        while (_blocked[i].load() < n) {
+            if (_compensating[i].compare_exchange_weak(n, n - 1)) return true;
+        }
+        return false;
+    }
+
+    void begin_blocking(unsigned i) override {
+        ++_blocked[i];
+        ++_compensating[i];
+
+        lock_t lock{_compensator_mutex};
+        if (_parked > _handoff.size()) {
+            _handoff.push_back(i);
+            _compensator_ready.notify_one();
+            return;
+        }
+        _compensators.emplace_back([this, i] { compensate(i); });
+    }
+
+    void end_blocking(unsigned i) override {
+        --_blocked[i];
+        _q[i].interrupt();
+    }
+
+    // Wake an idle worker, if any, so it can steal work pushed onto a local queue.
+    void wake_idle(unsigned i) {
+        if (_idle.load(std::memory_order_relaxed) == 0) return;
+        for (unsigned n = 1; n != _count; ++n) {
+            if (_q[(i + n) % _count].wake()) return;
+        }
+    }
+
+public:
+    explicit priority_task_system(task_system_options options = {}) :
+        _count(std::max(1u, options._count)), _name(std::move(options._name)), _q(_count),
+        _placement(options._placement), _idle_policy(options._idle),
+        _on_thread_start(std::move(options._on_thread_start)),
+        _on_thread_stop(std::move(options._on_thread_stop)),
+        _on_idle(std::move(options._on_idle)), _steal_order(_count),
+        _blocked(_count), _compensating(_count), _counters(_count) {
+        std::vector<unsigned> node(_count, 0);
+        std::vector<std::vector<int>> cpus(_count);
+
+        if (options._affinity != thread_affinity::none) {
+            std::vector<std::pair<int, unsigned>> all; // (cpu, node) in node order
+            auto topology = cpu_topology();
+            for (std::size_t k = 0; k != topology.size(); ++k) {
+                for (auto cpu : topology[k]) all.emplace_back(cpu, static_cast<unsigned>(k));
+            }
+
+            for (unsigned n = 0; !all.empty() && n != _count; ++n) {
+                // Spread the workers evenly across the CPUs, and so across the nodes.
+                auto k = _count <= all.size() ? n * all.size() / _count : n % all.size();
+                node[n] = all[k].second;
+                if (options._affinity == thread_affinity::cpu) cpus[n] = {all[k].first};
+                else cpus[n] = topology[node[n]];
+            }
+        }
+
+        for (unsigned i = 0; i != _count; ++i) {
+            for (unsigned n = 1; n != _count; ++n) {
+                if (node[(i + n) % _count] == node[i]) _steal_order[i].push_back((i + n) % _count);
+            }
+            for (unsigned n = 1; n != _count; ++n) {
+                if (node[(i + n) % _count] != node[i]) _steal_order[i].push_back((i + n) % _count);
+            }
+        }
+
+        for (auto& e : _q) e.set_aging(options._aging);
+
+        _threads.reserve(_count);
+        for (unsigned n = 0; n != _count; ++n) {
+            _threads.emplace_back([&, n, c = std::move(cpus[n])] { run(n, c); });
+        }
+    }
+
+    ~priority_task_system() {
+        for (auto& e : _q) e.done();
+        {
+            lock_t lock{_compensator_mutex};
+            _done = true;
+        }
+        _compensator_ready.notify_all();
+        for (auto& e : _threads) e.join();
+
+        // Compensating threads may start further compensating threads while they finish.
+        while (true) {
+            std::vector<std::thread> compensators;
+            {
+                lock_t lock{_compensator_mutex};
+                swap(compensators, _compensators);
+            }
+            if (compensators.empty()) break;
+            for (auto& e : compensators) e.join();
+        }
+    }
+
+    template <std::size_t P, typename F>
+    void execute(F&& f) {
+        static_assert(P < 3, "More than 3 priorities are not known!");
+
+#if STLAB_FEATURE(TASK_SYSTEM_TRACE)
+        if (trace_active()) return execute_<P>(traced(std::forward<F>(f), P));
+#endif
+        execute_<P>(std::forward<F>(f));
+    }
+
+private:
+    template <std::size_t P, typename F>
+    void execute_(F&& f) {
+        if (_placement == task_placement::worker_local && this_worker()._system == this) {
+            auto i = this_worker()._index;
+            _q[i].push_local(std::forward<F>(f), P);
+            wake_idle(i);
+            return;
+        }
+
+        auto i = _index++;
+
+        for (unsigned n = 0; n != _count; ++n) {
+            if (_q[(i + n) % _count].try_push(std::forward<F>(f), P)) return;
+            _counters[(i + n) % _count].push_failed();
+        }
+
+        _q[i % _count].push(std::forward<F>(f), P);
+    }
+
+public:
+    /*
+        Moves the tasks in the forward range [first, last) into the task system. The range is
+        split into one contiguous chunk per queue, and each queue is locked and woken once.
+    */
+    template <std::size_t P, typename I>
+    void execute_n(I first, I last) {
+        static_assert(P < 3, "More than 3 priorities are not known!");
+
+        const auto n = static_cast<std::size_t>(std::distance(first, last));
+        if (n == 0) return;
+
+#if STLAB_FEATURE(TASK_SYSTEM_TRACE)
+        if (trace_active()) {
+            for (auto p = first; p != last; ++p) *p = traced(std::move(*p), P);
+        }
+#endif
+
+        const auto chunks = std::min<std::size_t>(n, _count);
+        const auto i = _index.fetch_add(static_cast<unsigned>(chunks));
+
+        for (std::size_t k = 0; k != chunks; ++k) {
+            auto next = std::next(first, (n * (k + 1)) / chunks - (n * k) / chunks);
+            _q[(i + k) % _count].push_n(first, next, P);
+            first = next;
+        }
+    }
+
+    unsigned size() const { return _count; }
+
+#if STLAB_FEATURE(TASK_SYSTEM_STATISTICS)
+    // A snapshot of the statistics of each worker, see worker_statistics.
+    std::vector<worker_statistics> statistics() {
+        std::vector<worker_statistics> result;
+        result.reserve(_count);
+        for (unsigned n = 0; n != _count; ++n) {
+            result.push_back(_counters[n].get());
+            result.back()._depth = _q[n].depth();
+        }
+        return result;
+    }
+
+    // Histograms of the queueing delay, indexed by high, medium, and low priority.
+    std::array<latency_histogram, 3> queue_delay() { return _queue_delay.get(false); }
+
+    // Like queue_delay() but starts new histograms.
+    std::array<latency_histogram, 3> reset_queue_delay() { return _queue_delay.get(true); }
+#endif
+
+    auto low_executor() { return task_system_executor<Queue, executor_priority::low>{*this}; }
+    auto executor() { return task_system_executor<Queue, executor_priority::medium>{*this}; }
+    auto high_executor() { return task_system_executor<Queue, executor_priority::high>{*this}; }
+
+    bool steal() {
+        task<void()> f;
+        submission s;
+
+        for (unsigned n = 0; n != _count; ++n) {
+            if (_q[n].try_steal(f, s)) break;
+        }
+        if (!f) return false;
+
+        _queue_delay.record(s);
+        f();
+
+        return true;
+    }
+};
+
+/*
+    A pool that starts a thread whenever a task arrives while all of its threads are busy, up to
+    _max threads, and ends threads that have been idle for _idle_timeout. It is meant for tasks
+    that block, so they do not hold up the workers of a priority_task_system.
+
+    _idle counts the idle threads that no submission has claimed yet. A submission claims an idle
+    thread or starts a new one. If neither is possible its task is counted in _backlog and
+    claimed by the next thread that finishes a task. An idle thread only ends if it is unclaimed,
+    so every queued task has a thread that will pick it up.
+*/
+
+class elastic_task_system {
+    using lock_t = std::unique_lock<std::mutex>;
+
+    // Shared with the threads, which are detached and may outlive the task system briefly.
+    struct shared {
+        const unsigned _max;
+        const std::chrono::nanoseconds _idle_timeout;
+        const std::string _name;
+
+        notification_queue _q;
+        std::mutex _mutex;
+        std::condition_variable _exited;
+        unsigned _threads{0};
+        unsigned _idle{0};
+        unsigned _backlog{0};
+        bool _done{false};
+
+        explicit shared(elastic_task_system_options options) :
+            _max(std::max(1u, options._max)), _idle_timeout(options._idle_timeout),
+            _name(std::move(options._name)) {}
+    };
+
+    std::shared_ptr<shared> _s;
+
+    static void run(const std::shared_ptr<shared>& s) {
+#if STLAB_FEATURE(THREAD_NAME_POSIX)
+        pthread_setname_np(pthread_self(), s->_name.substr(0, 15).c_str());
+#elif STLAB_FEATURE(THREAD_NAME_APPLE)
+        pthread_setname_np(s->_name.c_str());
+#endif
+#if STLAB_FEATURE(TASK_SYSTEM_TRACE)
+        this_trace_thread_name() = s->_name;
+#endif
+
+        while (true) {
+            task<void()> f;
+            if (s->_q.pop_for(f, s->_idle_timeout)) {
+                f();
+                f = nullptr;
+                lock_t lock{s->_mutex};
+                if (s->_backlog) --s->_backlog;
+                else ++s->_idle;
+                continue;
+            }
+
+            {
+                lock_t lock{s->_mutex};
+                // claimed by a submission, its task is on the way
+                if (!s->_done && s->_idle == 0) continue;
+                if (s->_idle) --s->_idle;
+                --s->_threads;
+            }
+            s->_exited.notify_all();
+            return;
+        }
+    }
+
+public:
+    explicit elastic_task_system(elastic_task_system_options options = {}) :
+        _s(std::make_shared<shared>(std::move(options))) {}
+
+    ~elastic_task_system() {
+        {
+            lock_t lock{_s->_mutex};
+            _s->_done = true;
+        }
+        _s->_q.done();
+
+        lock_t lock{_s->_mutex};
+        _s->_exited.wait(lock, [&] { return _s->_threads == 0; });
+    }
+
+    template <typename F>
+    void execute(F&& f) {
+        bool start = false;
+        {
+            lock_t lock{_s->_mutex};
+            if (_s->_idle) --_s->_idle;
+            else if (_s->_threads != _s->_max) {
+                ++_s->_threads;
+                start = true;
+            } else ++_s->_backlog;
+        }
+
+        if (start) {
+            try {
+                std::thread([_s = _s] { run(_s); }).detach();
+            } catch (...) {
+                lock_t lock{_s->_mutex};
+                --_s->_threads;
+                throw;
+            }
+        }
+
+        _s->_q.push(std::forward<F>(f), 1);
+    }
+
+    // The number of threads currently in the pool.
+    unsigned size() {
+        lock_t lock{_s->_mutex};
+        return _s->_threads;
+    }
+
+    auto executor() {
+        return [this](task<void()> f) { execute(std::move(f)); };
+    }
+};
+
+inline elastic_task_system& iots() {
+    static elastic_task_system only_task_system{
+        elastic_task_system_options{256, std::chrono::seconds(10), "cc.stlab.io_executor"}};
+    return only_task_system;
+}
+
+struct io_executor_type {
+    using result_type = void;
+
+    void operator()(task<void()> f) const { iots().execute(std::move(f)); }
+};
+
+#if defined(STLAB_FORCE_WORK_STEALING_QUEUE)
+using default_queue_t = work_stealing_queue;
+#else
+using default_queue_t = notification_queue;
+#endif
+
+inline priority_task_system<default_queue_t>& pts() {
+#if defined(STLAB_FORCE_WORK_STEALING_QUEUE)
+    static priority_task_system<default_queue_t> only_task_system{
+        task_system_options{queue_size(), "cc.stlab.default_executor", task_placement::worker_local,
+                            idle_policy::park()}};
+#else
+    static priority_task_system<default_queue_t> only_task_system;
+#endif
+    return only_task_system;
+}
+
+template <executor_priority P = executor_priority::medium>
+struct task_system
+{
+    using result_type = void;
+
+    void operator()(task<void()> f) const {
+        pts().execute<static_cast<std::size_t>(P)>(std::move(f));
+    }
+};
+
+#endif
+
+/**************************************************************************************************/
+
+#if STLAB_TASK_SYSTEM(WINDOWS) || STLAB_TASK_SYSTEM(PORTABLE)
+
+template <executor_priority P = executor_priority::medium>
+struct executor_type {
+    using result_type = void;
+
+    void operator()(task<void()> f) const {
+        static task_system<P> only_task_system;
+        only_task_system(std::move(f));
+    }
+
+#if STLAB_TASK_SYSTEM(PORTABLE)
+    // Submits the range of task<void()> in [first, last) as a batch, see bulk_execute().
+    template <typename I>
+    void bulk(I first, I last) const {
+        pts().execute_n<static_cast<std::size_t>(P)>(first, last);
+    }
+#endif
+};
+
+#endif
+
+/**************************************************************************************************/
+
+} // namespace detail
+
+/**************************************************************************************************/
+
+constexpr auto low_executor = detail::executor_type<detail::executor_priority::low>{};
+constexpr auto default_executor = detail::executor_type<detail::executor_priority::medium>{};
+constexpr auto high_executor = detail::executor_type<detail::executor_priority::high>{};
+
+/*
+    An executor for tasks that block on system calls. The portable task system runs them on an
+    elastic pool of its own, so they do not occupy the workers behind default_executor. A
+    continuation that should run on the CPU pool is attached with default_executor. The other
+    task systems add threads when tasks block, so there io_executor is default_executor.
+*/
+
+#if STLAB_TASK_SYSTEM(PORTABLE)
+constexpr auto io_executor = detail::io_executor_type{};
+#else
+constexpr auto io_executor = default_executor;
+#endif
+
+/**************************************************************************************************/
+
+/*
+    Tells the task system that the current thread is about to block, for example on I/O or on
+    another task. If the thread serves a queue of the portable task system, the task system starts
+    a thread that serves the queue in its place until the guard is destroyed, so blocked tasks do
+    not reduce the number of threads running tasks. Otherwise the guard does nothing.
+*/
+
+class blocking_guard {
+#if STLAB_TASK_SYSTEM(PORTABLE)
+    detail::managed_blocking* _system{detail::this_worker()._blocking};
+    unsigned _index{detail::this_worker()._index};
+
+public:
+    blocking_guard() {
+        if (_system) _system->begin_blocking(_index);
+    }
+    ~blocking_guard() {
+        if (_system) _system->end_blocking(_index);
+    }
+
+    // True if another thread serves the queue of the current thread while the guard is alive.
+    bool compensated() const { return _system != nullptr; }
+#else
+public:
+    blocking_guard() = default;
+
+    bool compensated() const { return false; }
+#endif
+
+    blocking_guard(const blocking_guard&) = delete;
+    blocking_guard& operator=(const blocking_guard&) = delete;
+};
+
+/**************************************************************************************************/
+
+#if STLAB_TASK_SYSTEM(PORTABLE)
+
+/*
+    A task system with its own worker threads, independent of the one behind default_executor.
+    Its executor(), low_executor(), and high_executor() can be used wherever default_executor can.
+*/
+
+using priority_task_system = detail::priority_task_system<detail::default_queue_t>;
+
+// An elastic pool like the one behind io_executor, see elastic_task_system_options.
+using elastic_task_system = detail::elastic_task_system;
+
+#endif
 
 /**************************************************************************************************/
 
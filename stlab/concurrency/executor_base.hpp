@@ -10,10 +10,16 @@
 #define STLAB_CONCURRENCY_EXECUTOR_BASE_HPP
 
 #include <chrono>
+#include <cstddef>
 #include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 #include <stlab/concurrency/system_timer.hpp>
 #include <stlab/concurrency/task.hpp>
+#include <stlab/concurrency/traits.hpp>
 
 /**************************************************************************************************/
 
@@ -24,7 +30,162 @@ namespace stlab {
 inline namespace v1 {
 /**************************************************************************************************/
 
-using executor_t = std::function<void(stlab::task<void()>)>;
+namespace detail {
+
+template <class E>
+using executor_call_t = decltype(std::declval<E&>()(std::declval<task<void()>>()));
+
+} // namespace detail
+
+/*
+    A copyable, type erased executor. It replaces std::function<void(task<void()>)>, which
+    allocates for anything larger than a couple of pointers and calls through two indirections.
+    Executors of up to detail::task_small_size bytes with a non-throwing move are stored inline,
+    which covers the stlab executors and lambdas capturing a shared_ptr or a few pointers, and a
+    call is a single indirect call. A moved from executor_t is empty, and like std::function,
+    calling an empty executor_t throws std::bad_function_call.
+*/
+
+class executor_t {
+    struct concept_t {
+        void (*dtor)(void*) noexcept;
+        void (*copy_ctor)(const void*, void*);
+        void (*move_ctor)(void*, void*) noexcept;
+    };
+
+    using invoke_t = void (*)(void*, task<void()>&&);
+
+    template <class F, bool Small>
+    struct model;
+
+    template <class F>
+    struct model<F, true> {
+        static void dtor(void* self) noexcept { static_cast<F*>(self)->~F(); }
+        static void copy_ctor(const void* self, void* p) {
+            new (p) F(*static_cast<const F*>(self));
+        }
+        static void move_ctor(void* self, void* p) noexcept {
+            new (p) F(std::move(*static_cast<F*>(self)));
+        }
+        static void invoke(void* self, task<void()>&& f) { (*static_cast<F*>(self))(std::move(f)); }
+
+        static const concept_t& vtable() {
+            static constexpr concept_t result = {dtor, copy_ctor, move_ctor};
+            return result;
+        }
+
+        template <class G>
+        static void construct(void* p, G&& f) {
+            new (p) F(std::forward<G>(f));
+        }
+    };
+
+    template <class F>
+    struct model<F, false> {
+        static F*& get(void* self) { return *static_cast<F**>(self); }
+
+        static void dtor(void* self) noexcept { delete get(self); }
+        static void copy_ctor(const void* self, void* p) {
+            new (p) F*(new F(**static_cast<F* const*>(self)));
+        }
+        // The source is destroyed right after, so it is left with nothing to delete.
+        static void move_ctor(void* self, void* p) noexcept {
+            new (p) F*(get(self));
+            get(self) = nullptr;
+        }
+        static void invoke(void* self, task<void()>&& f) { (*get(self))(std::move(f)); }
+
+        static const concept_t& vtable() {
+            static constexpr concept_t result = {dtor, copy_ctor, move_ctor};
+            return result;
+        }
+
+        template <class G>
+        static void construct(void* p, G&& f) {
+            new (p) F*(new F(std::forward<G>(f)));
+        }
+    };
+
+    // empty (default) vtable
+    static void dtor(void*) noexcept {}
+    static void copy_ctor(const void*, void*) {}
+    static void move_ctor(void*, void*) noexcept {}
+    static void invoke(void*, task<void()>&&) { throw std::bad_function_call(); }
+
+    static const concept_t& vtable() {
+        static constexpr concept_t result = {dtor, copy_ctor, move_ctor};
+        return result;
+    }
+
+    static constexpr std::size_t small_size = detail::task_small_size;
+
+    const concept_t* _vtable_ptr = &vtable();
+    invoke_t _invoke = invoke;
+    std::aligned_storage_t<small_size> _model;
+
+    // Moves the model of x into this, which must be empty, and leaves x empty.
+    void move_from(executor_t& x) noexcept {
+        _vtable_ptr = x._vtable_ptr;
+        _invoke = x._invoke;
+        _vtable_ptr->move_ctor(&x._model, &_model);
+        _vtable_ptr->dtor(&x._model);
+        x._vtable_ptr = &vtable();
+        x._invoke = invoke;
+    }
+
+public:
+    using result_type = void;
+
+    executor_t() noexcept = default;
+    executor_t(std::nullptr_t) noexcept {}
+
+    template <class F,
+              std::enable_if_t<!std::is_same<std::decay_t<F>, executor_t>::value &&
+                                   is_detected_v<detail::executor_call_t, std::decay_t<F>>,
+                               bool> = true>
+    executor_t(F&& f) {
+        using small_t = model<std::decay_t<F>, true>;
+        using large_t = model<std::decay_t<F>, false>;
+        using model_t = std::conditional_t<task_fits_inline<F, small_size>::value &&
+                                               std::is_nothrow_move_constructible<
+                                                   std::decay_t<F>>::value,
+                                           small_t, large_t>;
+
+        model_t::construct(&_model, std::forward<F>(f));
+        _vtable_ptr = &model_t::vtable();
+        _invoke = &model_t::invoke;
+    }
+
+    executor_t(const executor_t& x) : _vtable_ptr(x._vtable_ptr), _invoke(x._invoke) {
+        _vtable_ptr->copy_ctor(&x._model, &_model);
+    }
+
+    executor_t(executor_t&& x) noexcept { move_from(x); }
+
+    ~executor_t() { _vtable_ptr->dtor(&_model); }
+
+    executor_t& operator=(const executor_t& x) { return *this = executor_t(x); }
+
+    executor_t& operator=(executor_t&& x) noexcept {
+        if (this == &x) return *this;
+        _vtable_ptr->dtor(&_model);
+        move_from(x);
+        return *this;
+    }
+
+    executor_t& operator=(std::nullptr_t) noexcept { return *this = executor_t(); }
+
+    explicit operator bool() const { return _vtable_ptr != &vtable(); }
+
+    void operator()(task<void()> f) const {
+        _invoke(const_cast<void*>(static_cast<const void*>(&_model)), std::move(f));
+    }
+
+    friend inline bool operator==(const executor_t& x, std::nullptr_t) { return !x; }
+    friend inline bool operator==(std::nullptr_t, const executor_t& x) { return !x; }
+    friend inline bool operator!=(const executor_t& x, std::nullptr_t) { return !!x; }
+    friend inline bool operator!=(std::nullptr_t, const executor_t& x) { return !!x; }
+};
 
 /*
  * returns an executor that will schedule any passed task to it to execute
@@ -59,6 +220,31 @@ auto execute_delayed(std::chrono::duration<Rep, Per> duration, E executor) {
     return execute_at(duration, std::move(executor));
 }
 
+namespace detail {
+
+template <typename E, typename I>
+auto bulk_execute_(E& executor, I first, I last, int) -> decltype(executor.bulk(first, last)) {
+    return executor.bulk(first, last);
+}
+
+template <typename E, typename I>
+void bulk_execute_(E& executor, I first, I last, long) {
+    for (; first != last; ++first) executor(std::move(*first));
+}
+
+} // namespace detail
+
+/*
+ * moves the range of task<void()> in [first, last) to the executor. If the executor provides a
+ * bulk(first, last) member it is used to submit the tasks as a batch, otherwise each task is
+ * passed to the executor in turn
+ */
+
+template <typename E, typename I>
+void bulk_execute(E& executor, I first, I last) {
+    detail::bulk_execute_(executor, first, last, 0);
+}
+
 struct executor {
     executor_t _executor;
 };
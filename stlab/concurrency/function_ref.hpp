@@ -0,0 +1,115 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+/**************************************************************************************************/
+
+#ifndef STLAB_CONCURRENCY_FUNCTION_REF_HPP
+#define STLAB_CONCURRENCY_FUNCTION_REF_HPP
+
+#include <stlab/concurrency/traits.hpp>
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+/**************************************************************************************************/
+
+namespace stlab {
+
+/**************************************************************************************************/
+
+inline namespace v1 {
+
+/**************************************************************************************************/
+
+namespace detail {
+
+template <class F, class... Args>
+using call_result_t = decltype(std::declval<F>()(std::declval<Args>()...));
+
+// True if F can be called with Args and its result converts to R.
+template <class R, class F, class... Args>
+constexpr bool is_callable_r_v =
+    is_detected_v<call_result_t, F, Args...> &&
+    (std::is_void<R>::value ||
+     std::is_convertible<detected_t<call_result_t, F, Args...>, R>::value);
+
+} // namespace detail
+
+/**************************************************************************************************/
+
+/*
+    A non-owning reference to a callable. Unlike task, constructing a function_ref neither moves
+    nor allocates the callable, and calling it is a single indirect call. The referenced callable
+    must outlive the function_ref, so use it for parameters of functions that call the callable
+    before they return, never to store a callable for later. Functions and function pointers are
+    the exception, the function_ref holds the pointer itself and may outlive it.
+*/
+
+template <class>
+class function_ref;
+
+template <class R, class... Args>
+class function_ref<R(Args...)> {
+    // A function pointer may not fit in a void*, so it is stored as a function pointer.
+    union storage_t {
+        void* _object;
+        void (*_function)();
+    };
+
+    using invoke_t = R (*)(storage_t, Args...);
+
+    storage_t _storage;
+    invoke_t _invoke;
+
+    template <class F>
+    static R invoke(storage_t f, Args... args) {
+        return static_cast<R>((*static_cast<F*>(f._object))(std::forward<Args>(args)...));
+    }
+
+    template <class F>
+    static R invoke_function(storage_t f, Args... args) {
+        return static_cast<R>(reinterpret_cast<F*>(f._function)(std::forward<Args>(args)...));
+    }
+
+    template <class F>
+    using is_function_pointer = std::is_function<std::remove_pointer_t<std::decay_t<F>>>;
+
+public:
+    template <class F,
+              std::enable_if_t<!std::is_same<std::decay_t<F>, function_ref>::value &&
+                                   !is_function_pointer<F>::value &&
+                                   detail::is_callable_r_v<R, F&, Args...>,
+                               bool> = true>
+    function_ref(F&& f) noexcept : _invoke(&invoke<std::remove_reference_t<F>>) {
+        _storage._object = const_cast<void*>(static_cast<const volatile void*>(std::addressof(f)));
+    }
+
+    // Functions and function pointers are held by value, so a temporary pointer may be passed.
+    template <class F,
+              std::enable_if_t<std::is_function<F>::value &&
+                                   detail::is_callable_r_v<R, F&, Args...>,
+                               bool> = true>
+    function_ref(F* f) noexcept : _invoke(&invoke_function<F>) {
+        _storage._function = reinterpret_cast<void (*)()>(f);
+    }
+
+    R operator()(Args... args) const { return _invoke(_storage, std::forward<Args>(args)...); }
+};
+
+/**************************************************************************************************/
+
+} // namespace v1
+
+/**************************************************************************************************/
+
+} // namespace stlab
+
+/**************************************************************************************************/
+
+#endif // STLAB_CONCURRENCY_FUNCTION_REF_HPP
+
+/**************************************************************************************************/
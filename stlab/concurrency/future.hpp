@@ -21,6 +21,7 @@
 #include <stlab/concurrency/executor_base.hpp>
 #include <stlab/concurrency/optional.hpp>
 #include <stlab/concurrency/task.hpp>
+#include <stlab/concurrency/trace.hpp>
 #include <stlab/concurrency/traits.hpp>
 #include <stlab/concurrency/tuple_algorithm.hpp>
 #include <stlab/memory.hpp>
@@ -56,7 +57,8 @@ inline namespace v1 {
 enum class future_error_codes { // names for futures errors
     broken_promise = 1,
     reduction_failed,
-    no_state
+    no_state,
+    canceled
 };
 
 /**************************************************************************************************/
@@ -75,6 +77,9 @@ inline const char* Future_error_map(
         case future_error_codes::reduction_failed:
             return "reduction failed";
 
+        case future_error_codes::canceled:
+            return "canceled";
+
         default:
             return nullptr;
     }
@@ -292,6 +297,7 @@ struct shared_base<T, enable_if_copyable<T>> : std::enable_shared_from_this<shar
 
     template <typename E, typename F>
     auto then(E&& executor, F&& f) {
+        trace_origin_scope<std::decay_t<F>> origin;
         return recover(std::forward<E>(executor),
                        [_f = std::forward<F>(f)](const auto& x) {
                             return _f(x._p->get_ready()); 
@@ -314,9 +320,12 @@ struct shared_base<T, enable_if_copyable<T>> : std::enable_shared_from_this<shar
         {
             std::unique_lock<std::mutex> lock(_mutex);
             ready = _ready;
-            if (!ready) _then.emplace_back(std::move(executor), std::move(p.first));
+            if (!ready) {
+                _then.emplace_back(with_trace_origin<std::decay_t<F>>(std::move(executor)),
+                                   std::move(p.first));
+            }
         }
-        if (ready) executor(std::move(p.first));
+        if (ready) with_trace_origin<std::decay_t<F>>(executor)(std::move(p.first));
 
         return reduce(std::move(p.second));
     }
@@ -328,6 +337,7 @@ struct shared_base<T, enable_if_copyable<T>> : std::enable_shared_from_this<shar
 
     template <typename E, typename F>
     auto then_r(bool unique, E&& executor, F&& f) {
+        trace_origin_scope<std::decay_t<F>> origin;
         return recover_r(unique, std::forward<E>(executor), [_f = std::forward<F>(f)](auto&& x) mutable {
             return std::move(_f)(std::move(*(std::forward<decltype(x)>(x).get_try())));
         });
@@ -351,9 +361,12 @@ struct shared_base<T, enable_if_copyable<T>> : std::enable_shared_from_this<shar
         {
             std::unique_lock<std::mutex> lock(_mutex);
             ready = _ready;
-            if (!ready) _then.emplace_back(std::forward<E>(executor), std::move(p.first));
+            if (!ready) {
+                _then.emplace_back(with_trace_origin<std::decay_t<F>>(std::forward<E>(executor)),
+                                   std::move(p.first));
+            }
         }
-        if (ready) executor(std::move(p.first));
+        if (ready) with_trace_origin<std::decay_t<F>>(executor)(std::move(p.first));
 
         return reduce(std::move(p.second));
     }
@@ -458,6 +471,7 @@ struct shared_base<T, enable_if_not_copyable<T>> : std::enable_shared_from_this<
 
     template <typename E, typename F>
     auto then_r(bool unique, E&& executor, F&& f) {
+        trace_origin_scope<std::decay_t<F>> origin;
         return recover_r(
             unique, std::forward<E>(executor), [_f = std::forward<F>(f)](auto&& x) mutable {
                 return std::move(_f)(std::move(*std::forward<decltype(x)>(x).get_try()));
@@ -482,9 +496,12 @@ struct shared_base<T, enable_if_not_copyable<T>> : std::enable_shared_from_this<
         {
             std::unique_lock<std::mutex> lock(_mutex);
             ready = _ready;
-            if (!ready) _then = {std::move(executor), std::move(p.first)};
+            if (!ready) {
+                _then = {with_trace_origin<std::decay_t<F>>(std::move(executor)),
+                         std::move(p.first)};
+            }
         }
-        if (ready) executor(std::move(p.first));
+        if (ready) with_trace_origin<std::decay_t<F>>(executor)(std::move(p.first));
 
         return reduce(std::move(p.second));
     }
@@ -559,6 +576,7 @@ struct shared_base<void> : std::enable_shared_from_this<shared_base<void>> {
 
     template <typename E, typename F>
     auto then(E&& executor, F&& f) {
+        trace_origin_scope<std::decay_t<F>> origin;
         return recover(std::forward<E>(executor), [_f = std::forward<F>(f)](auto x) mutable {
             x.get_try(); // throw if error
             return std::move(_f)();
@@ -739,6 +757,9 @@ public:
         auto p = _p.lock();
         if (p) p->set_error(std::move(error));
     }
+
+    // True if the associated futures were destroyed, so the result is not needed anymore.
+    bool canceled() const { return _p.expired(); }
 };
 
 /**************************************************************************************************/
@@ -1604,6 +1625,40 @@ void attach_tasks(size_t index, E executor, const std::shared_ptr<C>& context, T
     context->_holds[index] = std::move(hold);
 }
 
+/*
+ * Continuations attached to futures that are already ready are scheduled immediately. While the
+ * continuations for a range of futures are attached, this executor collects those tasks so they can
+ * be submitted with a single bulk_execute() call. Once flushed it forwards to the wrapped executor.
+ */
+template <typename E>
+class bulk_collector {
+    struct state {
+        E _executor;
+        std::vector<task<void()>> _tasks;
+        std::atomic_bool _open{true};
+
+        explicit state(E executor) : _executor(std::move(executor)) {}
+    };
+
+    std::shared_ptr<state> _state;
+
+public:
+    explicit bulk_collector(E executor) : _state(std::make_shared<state>(std::move(executor))) {}
+
+    void operator()(task<void()> f) const {
+        if (_state->_open)
+            _state->_tasks.push_back(std::move(f));
+        else
+            _state->_executor(std::move(f));
+    }
+
+    void flush() const {
+        _state->_open = false;
+        bulk_execute(_state->_executor, begin(_state->_tasks), end(_state->_tasks));
+        _state->_tasks.clear();
+    }
+};
+
 template <typename R, typename T, typename C, typename Enabled = void>
 struct create_range_of_futures;
 
@@ -1619,10 +1674,15 @@ struct create_range_of_futures<R, T, C, enable_if_copyable<T>> {
 
         context->_f = std::move(p.first);
 
+        bulk_collector<E> collector{executor};
         size_t index(0);
         for (; first != last; ++first) {
-            attach_tasks(index++, executor, context, *first);
+            if ((*first).is_ready())
+                attach_tasks(index++, collector, context, *first);
+            else
+                attach_tasks(index++, executor, context, *first);
         }
+        collector.flush();
 
         return std::move(p.second);
     }
@@ -1640,10 +1700,15 @@ struct create_range_of_futures<R, T, C, enable_if_not_copyable<T>> {
 
         context->_f = std::move(p.first);
 
+        bulk_collector<E> collector{executor};
         size_t index(0);
         for (; first != last; ++first) {
-            attach_tasks(index++, executor, context, std::move(*first));
+            if ((*first).is_ready())
+                attach_tasks(index++, collector, context, std::move(*first));
+            else
+                attach_tasks(index++, executor, context, std::move(*first));
         }
+        collector.flush();
 
         return std::move(p.second);
     }
@@ -1717,6 +1782,7 @@ auto async(E executor, F&& f, Args&&... args)
                       },
                       std::forward<Args>(args)...));
 
+    detail::trace_origin_scope<std::decay_t<F>> origin;
     executor(std::move(p.first));
 
     return std::move(p.second);
@@ -1884,9 +1950,12 @@ auto shared_base<void>::recover(E&& executor, F&& f)
     {
         std::unique_lock<std::mutex> lock(_mutex);
         ready = _ready;
-        if (!ready) _then.emplace_back(std::forward<E>(executor), std::move(p.first));
+        if (!ready) {
+            _then.emplace_back(with_trace_origin<std::decay_t<F>>(std::forward<E>(executor)),
+                               std::move(p.first));
+        }
     }
-    if (ready) executor(std::move(p.first));
+    if (ready) with_trace_origin<std::decay_t<F>>(executor)(std::move(p.first));
 
     return reduce(std::move(p.second));
 }
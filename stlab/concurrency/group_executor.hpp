@@ -0,0 +1,236 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+/**************************************************************************************************/
+
+#ifndef STLAB_CONCURRENCY_GROUP_EXECUTOR_HPP
+#define STLAB_CONCURRENCY_GROUP_EXECUTOR_HPP
+
+#include <stlab/concurrency/default_executor.hpp>
+#include <stlab/concurrency/executor_base.hpp>
+#include <stlab/concurrency/task.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**************************************************************************************************/
+
+namespace stlab {
+
+/**************************************************************************************************/
+
+inline namespace v1 {
+
+/**************************************************************************************************/
+
+struct group_statistics {
+    std::size_t _queued{0};    // tasks waiting to be dispatched
+    std::size_t _running{0};   // tasks currently running
+    std::size_t _completed{0}; // tasks that finished running
+};
+
+/**************************************************************************************************/
+
+namespace detail {
+
+/**************************************************************************************************/
+
+/*
+    Stride scheduling over groups of tasks. Every group advances its pass by a stride inversely
+    proportional to its weight each time one of its tasks is dispatched, and the group with the
+    lowest pass goes next. A group that becomes busy again starts at the current pass, so idle
+    time does not accumulate as credit.
+
+    Each submitted task schedules one token on the executor, a token dispatches whichever task is
+    due. A token that finds every busy group at its max_inflight is deferred and rescheduled when a
+    task of the scheduler completes.
+*/
+
+class group_queue {
+    using lock_t = std::unique_lock<std::mutex>;
+
+    static constexpr std::uint64_t stride1() { return std::uint64_t{1} << 20; }
+
+public:
+    struct group {
+        const std::uint64_t _stride;
+        const std::size_t _max_inflight;
+        std::uint64_t _pass{0};
+        std::deque<task<void()>> _tasks;
+        std::size_t _running{0};
+        std::size_t _completed{0};
+
+        group(unsigned weight, std::size_t max_inflight) :
+            _stride(stride1() / std::max(weight, 1u)), _max_inflight(max_inflight) {}
+    };
+
+private:
+    std::mutex _mutex;
+    std::vector<std::shared_ptr<group>> _busy; // groups with queued tasks
+    std::uint64_t _pass{0};
+    std::size_t _deferred{0};
+    const executor_t _executor;
+
+    static void schedule(const std::shared_ptr<group_queue>& self) {
+        self->_executor([_self = self] { run_next(_self); });
+    }
+
+    static void run_next(const std::shared_ptr<group_queue>& self) {
+        std::shared_ptr<group> g;
+        task<void()> f;
+        {
+            lock_t lock{self->_mutex};
+            auto& busy = self->_busy;
+
+            auto p = busy.end();
+            for (auto i = busy.begin(); i != busy.end(); ++i) {
+                if ((*i)->_running == (*i)->_max_inflight) continue;
+                if (p == busy.end() || (*i)->_pass < (*p)->_pass) p = i;
+            }
+            if (p == busy.end()) {
+                ++self->_deferred;
+                return;
+            }
+
+            g = *p;
+            f = std::move(g->_tasks.front());
+            g->_tasks.pop_front();
+            ++g->_running;
+            self->_pass = g->_pass;
+            g->_pass += g->_stride;
+            if (g->_tasks.empty()) busy.erase(p);
+        }
+
+        try {
+            f();
+        } catch (...) {
+            complete(self, *g);
+            throw;
+        }
+        complete(self, *g);
+    }
+
+    // Releases the slot of g and reschedules a deferred run, even if the task threw.
+    static void complete(const std::shared_ptr<group_queue>& self, group& g) {
+        bool reschedule = false;
+        {
+            lock_t lock{self->_mutex};
+            --g._running;
+            ++g._completed;
+            if (self->_deferred) {
+                --self->_deferred;
+                reschedule = true;
+            }
+        }
+        if (reschedule) schedule(self);
+    }
+
+public:
+    explicit group_queue(executor_t executor) : _executor(std::move(executor)) {}
+
+    static void push(const std::shared_ptr<group_queue>& self,
+                     const std::shared_ptr<group>& g,
+                     task<void()> f) {
+        {
+            lock_t lock{self->_mutex};
+            if (g->_tasks.empty()) {
+                g->_pass = std::max(g->_pass, self->_pass);
+                self->_busy.push_back(g);
+            }
+            g->_tasks.push_back(std::move(f));
+        }
+        schedule(self);
+    }
+
+    group_statistics statistics(const group& g) {
+        lock_t lock{_mutex};
+        return {g._tasks.size(), g._running, g._completed};
+    }
+};
+
+/**************************************************************************************************/
+
+} // namespace detail
+
+/**************************************************************************************************/
+
+// An executor for one group of a group_scheduler, copies schedule into the same group.
+class group_executor {
+    std::shared_ptr<detail::group_queue> _queue;
+    std::shared_ptr<detail::group_queue::group> _group;
+
+public:
+    using result_type = void;
+
+    group_executor(std::shared_ptr<detail::group_queue> queue,
+                   std::shared_ptr<detail::group_queue::group> group) :
+        _queue(std::move(queue)), _group(std::move(group)) {}
+
+    void operator()(task<void()> f) const {
+        detail::group_queue::push(_queue, _group, std::move(f));
+    }
+
+    group_statistics statistics() const { return _queue->statistics(*_group); }
+
+    friend bool operator==(const group_executor& x, const group_executor& y) {
+        return x._group == y._group;
+    }
+    friend bool operator!=(const group_executor& x, const group_executor& y) { return !(x == y); }
+};
+
+/**************************************************************************************************/
+
+/*
+    Shares an executor between groups of tasks. While groups are busy each receives a share of
+    the dispatched tasks proportional to its weight, and never has more than max_inflight tasks
+    running, so a group that floods the scheduler does not starve the others.
+*/
+
+class group_scheduler {
+    std::shared_ptr<detail::group_queue> _queue;
+
+public:
+    explicit group_scheduler(executor_t executor) :
+        _queue(std::make_shared<detail::group_queue>(std::move(executor))) {}
+
+    group_executor make_group_executor(
+        unsigned weight = 1,
+        std::size_t max_inflight = std::numeric_limits<std::size_t>::max()) const {
+        assert(weight != 0 && max_inflight != 0 && "weight and max_inflight must be positive");
+        return {_queue, std::make_shared<detail::group_queue::group>(weight, max_inflight)};
+    }
+};
+
+/**************************************************************************************************/
+
+// A group of the scheduler shared by the process that dispatches to default_executor.
+inline group_executor make_group_executor(
+    unsigned weight = 1, std::size_t max_inflight = std::numeric_limits<std::size_t>::max()) {
+    static group_scheduler scheduler{default_executor};
+    return scheduler.make_group_executor(weight, max_inflight);
+}
+
+/**************************************************************************************************/
+
+} // namespace v1
+
+/**************************************************************************************************/
+
+} // namespace stlab
+
+/**************************************************************************************************/
+
+#endif // STLAB_CONCURRENCY_GROUP_EXECUTOR_HPP
+
+/**************************************************************************************************/
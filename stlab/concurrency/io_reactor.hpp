@@ -0,0 +1,328 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+/**************************************************************************************************/
+
+#ifndef STLAB_CONCURRENCY_IO_REACTOR_HPP
+#define STLAB_CONCURRENCY_IO_REACTOR_HPP
+
+#include <stlab/concurrency/config.hpp>
+
+#if STLAB_FEATURE(EPOLL)
+
+#include <stlab/concurrency/future.hpp>
+#include <stlab/concurrency/immediate_executor.hpp>
+#include <stlab/concurrency/task.hpp>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**************************************************************************************************/
+
+namespace stlab {
+
+/**************************************************************************************************/
+
+inline namespace v1 {
+
+/**************************************************************************************************/
+
+/*
+    An I/O reactor for Linux. read(), write(), and accept() return futures that are completed by
+    the reactor's own thread once the file descriptor is ready, so waiting for I/O does not occupy
+    a thread of the task system. Continuations attached without an executor run on the reactor
+    thread and should hand longer work to another executor.
+
+    An operation is attempted right away and only waits in epoll if it would block. Operations on
+    the same file descriptor and in the same direction complete in the order they were submitted.
+    Regular files are always ready, so their operations complete before the call returns.
+
+    The file descriptor is switched to non-blocking mode. It and the buffer must stay valid until
+    the operation completes or its future is destroyed. If the reactor is destroyed first the
+    futures of pending operations fail with broken_promise. If waiting in epoll fails, pending
+    operations and later ones that would block fail with that std::system_error.
+*/
+
+class io_reactor {
+    using lock_t = std::unique_lock<std::mutex>;
+
+    /*
+        Performs the system call, or fails with the given error if it is not null. Returns an
+        empty task if the call would block, otherwise the task that completes the future, which
+        is run without holding the lock.
+    */
+    using attempt_t = task<task<void()>(std::exception_ptr)>;
+
+    struct entry {
+        std::deque<attempt_t> _reads;
+        std::deque<attempt_t> _writes;
+        std::uint32_t _events{0}; // the events currently registered with epoll
+    };
+
+    std::mutex _mutex;
+    std::unordered_map<int, entry> _entries;
+    bool _done{false};
+    std::exception_ptr _error; // set once epoll_wait fails, the reactor thread has then exited
+    int _event{-1};
+    int _epoll{-1};
+    std::thread _thread;
+
+    static std::error_code last_error() { return std::error_code(errno, std::system_category()); }
+
+    static void set_non_blocking(int fd) {
+        int flags = ::fcntl(fd, F_GETFL);
+        if (flags >= 0 && !(flags & O_NONBLOCK)) ::fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+
+    template <class R, class F>
+    static attempt_t make_attempt(packaged_task<R> promise, F io) {
+        return [_promise = std::move(promise),
+                _io = std::move(io)](std::exception_ptr error) mutable -> task<void()> {
+            // The future was destroyed, drop the operation without touching the buffer.
+            if (_promise.canceled()) return [] {};
+
+            if (error) {
+                return [_promise = std::move(_promise), error] { _promise.set_exception(error); };
+            }
+
+            decltype(_io()) result;
+            do {
+                result = _io();
+            } while (result < 0 && errno == EINTR);
+
+            if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return {};
+
+            if (result < 0) {
+                return [_promise = std::move(_promise), _error = last_error()] {
+                    _promise.set_exception(std::make_exception_ptr(std::system_error(_error)));
+                };
+            }
+            return [_promise = std::move(_promise), result] { _promise(static_cast<R>(result)); };
+        };
+    }
+
+    static void run_queue(std::deque<attempt_t>& queue, std::vector<task<void()>>& completions) {
+        while (!queue.empty()) {
+            auto completion = queue.front()(nullptr);
+            if (!completion) return;
+            completions.push_back(std::move(completion));
+            queue.pop_front();
+        }
+    }
+
+    // Registers the events of the pending operations on fd with epoll. Must be called under lock.
+    void update(int fd, std::vector<task<void()>>& completions) {
+        auto p = _entries.find(fd);
+        auto& e = p->second;
+
+        std::uint32_t events = (e._reads.empty() ? 0u : std::uint32_t{EPOLLIN}) |
+                               (e._writes.empty() ? 0u : std::uint32_t{EPOLLOUT});
+        if (events == e._events) return;
+
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+
+        int result = 0;
+        if (events == 0) result = ::epoll_ctl(_epoll, EPOLL_CTL_DEL, fd, &ev);
+        else if (e._events == 0) result = ::epoll_ctl(_epoll, EPOLL_CTL_ADD, fd, &ev);
+        else result = ::epoll_ctl(_epoll, EPOLL_CTL_MOD, fd, &ev);
+
+        if (result < 0 && events != 0) {
+            // The descriptor cannot be waited on, fail its pending operations.
+            auto error = std::make_exception_ptr(std::system_error(last_error(), "epoll_ctl"));
+            for (auto* queue : {&e._reads, &e._writes}) {
+                for (auto& attempt : *queue) completions.push_back(attempt(error));
+                queue->clear();
+            }
+            events = 0;
+        }
+
+        e._events = events;
+        if (events == 0) _entries.erase(p);
+    }
+
+    void submit(int fd, bool write, attempt_t attempt) {
+        set_non_blocking(fd);
+
+        std::vector<task<void()>> completions;
+        {
+            lock_t lock{_mutex};
+            auto& e = _entries[fd];
+            auto& queue = write ? e._writes : e._reads;
+
+            if (queue.empty()) {
+                auto completion = attempt(nullptr);
+                if (!completion && _error) completion = attempt(_error);
+                if (completion) {
+                    completions.push_back(std::move(completion));
+                    if (e._events == 0 && e._reads.empty() && e._writes.empty()) {
+                        _entries.erase(fd);
+                    }
+                } else {
+                    queue.push_back(std::move(attempt));
+                    update(fd, completions);
+                }
+            } else {
+                queue.push_back(std::move(attempt));
+            }
+        }
+        for (auto& e : completions) e();
+    }
+
+    // Fails the pending operations with error, later operations that would block fail with it.
+    void fail(std::exception_ptr error) {
+        std::vector<task<void()>> completions;
+        {
+            lock_t lock{_mutex};
+            _error = error;
+            for (auto& p : _entries) {
+                for (auto* queue : {&p.second._reads, &p.second._writes}) {
+                    for (auto& attempt : *queue) completions.push_back(attempt(error));
+                }
+            }
+            _entries.clear();
+        }
+        for (auto& e : completions) e();
+    }
+
+    void run() {
+        epoll_event events[64];
+
+        while (true) {
+            int n = ::epoll_wait(_epoll, events, 64, -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return fail(std::make_exception_ptr(std::system_error(last_error(), "epoll_wait")));
+            }
+
+            std::vector<task<void()>> completions;
+            {
+                lock_t lock{_mutex};
+                if (_done) return;
+
+                for (int i = 0; i != n; ++i) {
+                    auto fd = events[i].data.fd;
+                    auto p = _entries.find(fd);
+                    if (fd == _event || p == _entries.end()) continue;
+
+                    auto ready = events[i].events;
+                    if (ready & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+                        run_queue(p->second._reads, completions);
+                    }
+                    if (ready & (EPOLLOUT | EPOLLERR | EPOLLHUP)) {
+                        run_queue(p->second._writes, completions);
+                    }
+                    update(fd, completions);
+                }
+            }
+            for (auto& e : completions) e();
+        }
+    }
+
+public:
+    io_reactor() {
+        _event = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (_event < 0) throw std::system_error(last_error(), "eventfd");
+
+        _epoll = ::epoll_create1(EPOLL_CLOEXEC);
+        if (_epoll < 0) {
+            auto error = last_error();
+            ::close(_event);
+            throw std::system_error(error, "epoll_create1");
+        }
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = _event;
+        ::epoll_ctl(_epoll, EPOLL_CTL_ADD, _event, &ev);
+
+        _thread = std::thread([this] { run(); });
+    }
+
+    io_reactor(const io_reactor&) = delete;
+    io_reactor& operator=(const io_reactor&) = delete;
+
+    ~io_reactor() {
+        {
+            lock_t lock{_mutex};
+            _done = true;
+        }
+        std::uint64_t one = 1;
+        while (::write(_event, &one, sizeof(one)) < 0 && errno == EINTR) {}
+        _thread.join();
+
+        _entries.clear();
+        ::close(_epoll);
+        ::close(_event);
+    }
+
+    // Reads up to size bytes into buffer. The result is the number of bytes read, 0 at the end.
+    future<std::size_t> read(int fd, void* buffer, std::size_t size) {
+        auto p = package<std::size_t(std::size_t)>(immediate_executor,
+                                                   [](std::size_t n) { return n; });
+        submit(fd, false,
+               make_attempt(std::move(p.first), [=] { return ::read(fd, buffer, size); }));
+        return std::move(p.second);
+    }
+
+    // Writes up to size bytes from buffer. The result is the number of bytes written.
+    future<std::size_t> write(int fd, const void* buffer, std::size_t size) {
+        auto p = package<std::size_t(std::size_t)>(immediate_executor,
+                                                   [](std::size_t n) { return n; });
+        submit(fd, true,
+               make_attempt(std::move(p.first), [=] { return ::write(fd, buffer, size); }));
+        return std::move(p.second);
+    }
+
+    // Accepts a connection on the listening socket fd. The result is the non-blocking socket.
+    future<int> accept(int fd) {
+        auto p = package<int(int)>(immediate_executor, [](int s) { return s; });
+        submit(fd, false, make_attempt(std::move(p.first), [=] {
+                   return ::accept4(fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+               }));
+        return std::move(p.second);
+    }
+};
+
+/**************************************************************************************************/
+
+// A reactor shared by the process, started on first use.
+inline io_reactor& default_io_reactor() {
+    static io_reactor result;
+    return result;
+}
+
+/**************************************************************************************************/
+
+} // namespace v1
+
+/**************************************************************************************************/
+
+} // namespace stlab
+
+/**************************************************************************************************/
+
+#endif // STLAB_FEATURE(EPOLL)
+
+#endif // STLAB_CONCURRENCY_IO_REACTOR_HPP
+
+/**************************************************************************************************/
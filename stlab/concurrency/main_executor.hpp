@@ -53,6 +53,9 @@
 #if 0 && __APPLE__
 #include <dispatch/dispatch.h>
 #endif
+#if !__APPLE__
+#include <stlab/concurrency/run_loop.hpp>
+#endif
 #endif
 
 /**************************************************************************************************/
@@ -173,7 +176,10 @@ struct main_executor_type {};
 
 #elif STLAB_MAIN_EXECUTOR == STLAB_MAIN_EXECUTOR_PORTABLE
 
-// TODO (sparent) : provide a scheduler and run-loop - this is provide for testing on mac
+/*
+    On macOS tasks go to the dispatch main queue. Elsewhere they go to main_loop(), which the
+    main thread runs with main_loop().run(), poll(), or run_until().
+*/
 struct main_executor_type {
     using result_type = void;
 
@@ -188,6 +194,8 @@ struct main_executor_type {
             delete f;
         });
     }
+#else
+    void operator()(task<void()> f) const { main_loop().post(std::move(f)); }
 #endif // __APPLE__
 };
 
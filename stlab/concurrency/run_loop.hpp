@@ -0,0 +1,328 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+/**************************************************************************************************/
+
+#ifndef STLAB_CONCURRENCY_RUN_LOOP_HPP
+#define STLAB_CONCURRENCY_RUN_LOOP_HPP
+
+#include <stlab/concurrency/config.hpp>
+#include <stlab/concurrency/future.hpp>
+#include <stlab/concurrency/immediate_executor.hpp>
+#include <stlab/concurrency/task.hpp>
+#include <stlab/concurrency/utility.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#if STLAB_FEATURE(EPOLL)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <system_error>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+/**************************************************************************************************/
+
+namespace stlab {
+
+/**************************************************************************************************/
+
+inline namespace v1 {
+
+/**************************************************************************************************/
+
+namespace detail {
+
+/**************************************************************************************************/
+
+/*
+    A multiple producer, single consumer task queue. push() may be called from any thread and
+    links the task onto a lock-free stack. take() swaps out the whole stack with a single
+    exchange and appends it, in the order it was pushed, to a batch that only the consumer
+    touches. pop() and take() must only be called by one thread at a time.
+*/
+
+class mpsc_task_queue {
+    struct node {
+        node* _next{nullptr};
+        task<void()> _task;
+    };
+
+    std::atomic<node*> _pushed{nullptr};
+    node* _first{nullptr};
+    node* _last{nullptr};
+
+public:
+    mpsc_task_queue() = default;
+    mpsc_task_queue(const mpsc_task_queue&) = delete;
+    mpsc_task_queue& operator=(const mpsc_task_queue&) = delete;
+
+    ~mpsc_task_queue() {
+        take();
+        task<void()> f;
+        while (pop(f)) {}
+    }
+
+    void push(task<void()> f) {
+        auto n = new node;
+        n->_task = std::move(f);
+        n->_next = _pushed.load(std::memory_order_relaxed);
+        while (!_pushed.compare_exchange_weak(n->_next, n, std::memory_order_release,
+                                              std::memory_order_relaxed)) {}
+    }
+
+    // Moves the tasks pushed so far behind the batch, returns false if there were none.
+    bool take() {
+        node* n = _pushed.exchange(nullptr, std::memory_order_acquire);
+        if (!n) return false;
+
+        node* last = n;
+        node* first = nullptr;
+        while (n) {
+            node* next = n->_next;
+            n->_next = first;
+            first = n;
+            n = next;
+        }
+
+        if (_last) _last->_next = first;
+        else _first = first;
+        _last = last;
+        return true;
+    }
+
+    // Pops the next task of the batch, tasks pushed since the last take() are not seen.
+    bool pop(task<void()>& f) {
+        if (!_first) return false;
+        node* n = _first;
+        _first = n->_next;
+        if (!_first) _last = nullptr;
+        f = std::move(n->_task);
+        delete n;
+        return true;
+    }
+
+    bool empty() const { return !_first && !_pushed.load(std::memory_order_acquire); }
+};
+
+/**************************************************************************************************/
+
+} // namespace detail
+
+/**************************************************************************************************/
+
+class run_loop;
+
+namespace detail {
+
+struct run_loop_executor {
+    using result_type = void;
+
+    run_loop* _loop;
+
+    void operator()(task<void()> f) const;
+
+    friend bool operator==(const run_loop_executor& x, const run_loop_executor& y) {
+        return x._loop == y._loop;
+    }
+    friend bool operator!=(const run_loop_executor& x, const run_loop_executor& y) {
+        return !(x == y);
+    }
+};
+
+} // namespace detail
+
+/**************************************************************************************************/
+
+/*
+    A single threaded run loop. Tasks may be posted from any thread through executor(), and are
+    run in the order they were posted by the thread that calls run(), poll(), or run_until().
+    Only one thread at a time may run the loop. On Linux an idle loop waits in epoll on an
+    eventfd, which is only written when the loop may be asleep.
+*/
+
+class run_loop {
+    detail::mpsc_task_queue _queue;
+    std::atomic_bool _signaled{false};
+    std::atomic_bool _stop{false};
+
+#if STLAB_FEATURE(EPOLL)
+    int _event{-1};
+    int _epoll{-1};
+#else
+    std::mutex _mutex;
+    std::condition_variable _ready;
+#endif
+
+    void signal() {
+        if (_signaled.exchange(true)) return;
+#if STLAB_FEATURE(EPOLL)
+        std::uint64_t one = 1;
+        while (::write(_event, &one, sizeof(one)) < 0 && errno == EINTR) {}
+#else
+        { std::unique_lock<std::mutex> lock{_mutex}; }
+        _ready.notify_one();
+#endif
+    }
+
+    // Blocks until a task may have been posted or done() holds.
+    template <class P>
+    void wait(P done) {
+        _signaled.store(false);
+        if (!_queue.empty() || done()) return;
+
+#if STLAB_FEATURE(EPOLL)
+        epoll_event e;
+        while (::epoll_wait(_epoll, &e, 1, -1) < 0 && errno == EINTR) {}
+        std::uint64_t count;
+        while (::read(_event, &count, sizeof(count)) < 0 && errno == EINTR) {}
+#else
+        std::unique_lock<std::mutex> lock{_mutex};
+        _ready.wait(lock, [&] { return _signaled.load(); });
+#endif
+    }
+
+    /*
+        Swaps out the tasks posted so far and runs them until done() holds, returns how many
+        were run. Tasks posted while draining wait for the next call.
+    */
+    template <class P>
+    std::size_t drain(P done) {
+        std::size_t result = 0;
+        task<void()> f;
+        _queue.take();
+        while (!done() && _queue.pop(f)) {
+            f();
+            ++result;
+        }
+        return result;
+    }
+
+public:
+    run_loop() {
+#if STLAB_FEATURE(EPOLL)
+        _event = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (_event < 0) throw std::system_error(errno, std::system_category(), "eventfd");
+
+        _epoll = ::epoll_create1(EPOLL_CLOEXEC);
+        if (_epoll < 0) {
+            auto error = errno;
+            ::close(_event);
+            throw std::system_error(error, std::system_category(), "epoll_create1");
+        }
+
+        epoll_event e{};
+        e.events = EPOLLIN;
+        e.data.fd = _event;
+        if (::epoll_ctl(_epoll, EPOLL_CTL_ADD, _event, &e) < 0) {
+            auto error = errno;
+            ::close(_epoll);
+            ::close(_event);
+            throw std::system_error(error, std::system_category(), "epoll_ctl");
+        }
+#endif
+    }
+
+    run_loop(const run_loop&) = delete;
+    run_loop& operator=(const run_loop&) = delete;
+
+    // Tasks that have not run are destroyed without running.
+    ~run_loop() {
+#if STLAB_FEATURE(EPOLL)
+        ::close(_epoll);
+        ::close(_event);
+#endif
+    }
+
+    auto executor() { return detail::run_loop_executor{this}; }
+
+    void post(task<void()> f) {
+        _queue.push(std::move(f));
+        signal();
+    }
+
+    // Runs tasks until stop() is called.
+    void run() {
+        auto stopped = [&] { return _stop.load(); };
+        while (!stopped()) {
+            drain(stopped);
+            wait(stopped);
+        }
+        _stop = false;
+    }
+
+    // Runs the tasks posted before the call without blocking, returns how many were run.
+    std::size_t poll() {
+        return drain([] { return false; });
+    }
+
+    // Makes the current, or the next, call to run() return.
+    void stop() {
+        _stop = true;
+        signal();
+    }
+
+    /*
+        Runs tasks until x is ready and returns its result, or rethrows its exception. A call to
+        stop() does not end run_until() but the next call to run().
+    */
+    template <class T>
+    T run_until(future<T> x) {
+        std::atomic_bool ready{false};
+
+        auto hold = std::move(x).recover(immediate_executor, [&](auto&& r) {
+            x = std::forward<decltype(r)>(r);
+            ready = true;
+            signal();
+        });
+
+        auto is_ready = [&] { return ready.load(); };
+        while (!is_ready()) {
+            drain(is_ready);
+            wait(is_ready);
+        }
+
+        return detail::_get_ready_future<T>{}(std::move(x));
+    }
+};
+
+/**************************************************************************************************/
+
+namespace detail {
+
+inline void run_loop_executor::operator()(task<void()> f) const { _loop->post(std::move(f)); }
+
+} // namespace detail
+
+/**************************************************************************************************/
+
+// The run loop that main_executor posts to on platforms without a native main loop.
+inline run_loop& main_loop() {
+    static run_loop result;
+    return result;
+}
+
+/**************************************************************************************************/
+
+} // namespace v1
+
+/**************************************************************************************************/
+
+} // namespace stlab
+
+/**************************************************************************************************/
+
+#endif // STLAB_CONCURRENCY_RUN_LOOP_HPP
+
+/**************************************************************************************************/
@@ -22,6 +22,7 @@
 #define STLAB_DISABLE_FUTURE_COROUTINES()
 #endif
 
+#include <stlab/concurrency/executor_base.hpp>
 #include <stlab/concurrency/future.hpp>
 #include <stlab/concurrency/task.hpp>
 
@@ -43,7 +44,6 @@ namespace detail {
 /**************************************************************************************************/
 
 class serial_instance_t : public std::enable_shared_from_this<serial_instance_t> {
-    using executor_t = std::function<void(task<void()>&&)>;
     using queue_t = std::deque<task<void()>>;
     using lock_t = std::lock_guard<std::mutex>;
 
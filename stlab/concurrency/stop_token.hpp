@@ -0,0 +1,187 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+/**************************************************************************************************/
+
+#ifndef STLAB_CONCURRENCY_STOP_TOKEN_HPP
+#define STLAB_CONCURRENCY_STOP_TOKEN_HPP
+
+#include <stlab/concurrency/future.hpp>
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+/**************************************************************************************************/
+
+namespace stlab {
+
+/**************************************************************************************************/
+
+inline namespace v1 {
+
+/**************************************************************************************************/
+
+/*
+    Cooperative cancellation. A stop_source hands out stop_tokens, and request_stop() is observed
+    by all of them. Long running work checks stop_requested() on its token and returns early.
+
+    Functions passed to async(), then(), recover(), when_all(), or used as channel processes can
+    be wrapped with with_stop(). Once a stop is requested a wrapped function is not invoked
+    anymore and fails with future_error_codes::canceled instead, so the rest of a future chain is
+    skipped and resolves with the cancellation error, and a channel sends it downstream. For a
+    channel process with await() and yield() the wrapper forwards await(), yield(), state(),
+    close(), and set_error(), and skips await() and yield() the same way.
+*/
+
+namespace detail {
+
+struct stop_state {
+    std::atomic_bool _stopped{false};
+};
+
+} // namespace detail
+
+/**************************************************************************************************/
+
+class stop_token {
+    std::shared_ptr<const detail::stop_state> _state;
+
+    friend class stop_source;
+
+    explicit stop_token(std::shared_ptr<const detail::stop_state> state) :
+        _state(std::move(state)) {}
+
+public:
+    // A token without a source, a stop is never requested.
+    stop_token() = default;
+
+    bool stop_requested() const noexcept {
+        return _state && _state->_stopped.load(std::memory_order_acquire);
+    }
+
+    bool stop_possible() const noexcept { return static_cast<bool>(_state); }
+
+    friend bool operator==(const stop_token& x, const stop_token& y) {
+        return x._state == y._state;
+    }
+    friend bool operator!=(const stop_token& x, const stop_token& y) { return !(x == y); }
+};
+
+/**************************************************************************************************/
+
+class stop_source {
+    std::shared_ptr<detail::stop_state> _state{std::make_shared<detail::stop_state>()};
+
+public:
+    stop_token get_token() const { return stop_token{_state}; }
+
+    // Returns true if this call requested the stop.
+    bool request_stop() noexcept { return !_state->_stopped.exchange(true); }
+
+    bool stop_requested() const noexcept { return _state->_stopped.load(); }
+};
+
+/**************************************************************************************************/
+
+namespace detail {
+
+template <class F>
+using yield_result_t = decltype(std::declval<F&>().yield());
+
+} // namespace detail
+
+template <class F, class = void>
+class stoppable {
+    stop_token _token;
+    F _f;
+
+    void check() const {
+        if (_token.stop_requested()) throw future_error(future_error_codes::canceled);
+    }
+
+public:
+    stoppable(stop_token token, F f) : _token(std::move(token)), _f(std::move(f)) {}
+
+    template <class... Args>
+    auto operator()(Args&&... args) -> decltype(std::declval<F&>()(std::forward<Args>(args)...)) {
+        check();
+        return _f(std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    auto operator()(Args&&... args) const
+        -> decltype(std::declval<const F&>()(std::forward<Args>(args)...)) {
+        check();
+        return _f(std::forward<Args>(args)...);
+    }
+};
+
+/*
+    A channel process with await() and yield(). The channel takes the address of yield(), so it
+    is not a template here. The other members only exist if F has them.
+*/
+template <class F>
+class stoppable<F, std::enable_if_t<is_detected_v<detail::yield_result_t, F>>> {
+    stop_token _token;
+    F _f;
+
+    void check() const {
+        if (_token.stop_requested()) throw future_error(future_error_codes::canceled);
+    }
+
+public:
+    stoppable(stop_token token, F f) : _token(std::move(token)), _f(std::move(f)) {}
+
+    template <class... Args>
+    auto await(Args&&... args) -> decltype(std::declval<F&>().await(std::forward<Args>(args)...)) {
+        check();
+        return _f.await(std::forward<Args>(args)...);
+    }
+
+    auto yield() -> decltype(std::declval<F&>().yield()) {
+        check();
+        return _f.yield();
+    }
+
+    template <class G = F>
+    auto state() const -> decltype(std::declval<const G&>().state()) {
+        return _f.state();
+    }
+
+    template <class G = F>
+    auto close() -> decltype(std::declval<G&>().close()) {
+        return _f.close();
+    }
+
+    template <class G = F>
+    auto set_error(std::exception_ptr error)
+        -> decltype(std::declval<G&>().set_error(std::move(error))) {
+        return _f.set_error(std::move(error));
+    }
+};
+
+// Wraps f so it is not invoked once a stop is requested on token, see stop_source.
+template <class F>
+auto with_stop(stop_token token, F&& f) {
+    return stoppable<std::decay_t<F>>{std::move(token), std::forward<F>(f)};
+}
+
+/**************************************************************************************************/
+
+} // namespace v1
+
+/**************************************************************************************************/
+
+} // namespace stlab
+
+/**************************************************************************************************/
+
+#endif // STLAB_CONCURRENCY_STOP_TOKEN_HPP
+
+/**************************************************************************************************/
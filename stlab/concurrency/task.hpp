@@ -13,6 +13,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <functional>
 #include <memory>
 #include <type_traits>
@@ -30,15 +31,94 @@ inline namespace v1 {
 
 /**************************************************************************************************/
 
+namespace detail {
+
+/*
+    The default size of the inline buffer of a task. See the layout description in task for the
+    rationale.
+*/
+constexpr std::size_t task_small_size =
+    std::max(alignof(std::max_align_t) * 2, sizeof(void*) * 8) -
+    std::max(alignof(std::max_align_t), sizeof(void*) * 2);
+
+/**************************************************************************************************/
+
+/*
+    The deleter of a callable allocated with an allocator, see task(std::allocator_arg_t, ...).
+    The allocator's pointer type must be convertible to and from F*.
+*/
+template <class F, class Alloc>
+class allocator_delete {
+    using alloc_t = typename std::allocator_traits<Alloc>::template rebind_alloc<F>;
+    using traits_t = std::allocator_traits<alloc_t>;
+    using pointer_t = typename traits_t::pointer;
+
+    alloc_t _alloc;
+
+public:
+    explicit allocator_delete(const Alloc& alloc) : _alloc(alloc) {}
+
+    void operator()(F* p) {
+        traits_t::destroy(_alloc, p);
+        traits_t::deallocate(_alloc, std::pointer_traits<pointer_t>::pointer_to(*p), 1);
+    }
+
+    template <class G>
+    static auto make(const Alloc& alloc, G&& f) {
+        allocator_delete deleter{alloc};
+        pointer_t p = traits_t::allocate(deleter._alloc, 1);
+        try {
+            traits_t::construct(deleter._alloc, std::addressof(*p), std::forward<G>(f));
+        } catch (...) {
+            traits_t::deallocate(deleter._alloc, p, 1);
+            throw;
+        }
+        return std::unique_ptr<F, allocator_delete>(std::addressof(*p), std::move(deleter));
+    }
+};
+
+} // namespace detail
+
+/**************************************************************************************************/
+
+/*
+    True if an object of type T can be moved by copying its bytes, after which the source is
+    dropped without running its destructor. A task moves such callables with a memcpy of their
+    size instead of an indirect call. Specialize it for types that manage a resource through a
+    plain pointer and have no self references.
+*/
+template <class T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <class T, class D>
+struct is_trivially_relocatable<std::unique_ptr<T, D>> : is_trivially_relocatable<D> {};
+
+template <class T>
+struct is_trivially_relocatable<std::default_delete<T>> : std::true_type {};
+
+/*
+    True if a task with an inline buffer of N bytes stores a callable of type F without a heap
+    allocation. Use it in a static_assert to keep a continuation allocation free.
+*/
+template <class F, std::size_t N = detail::task_small_size>
+struct task_fits_inline
+    : std::integral_constant<bool, (sizeof(std::decay_t<F>) <= N) &&
+                                       (alignof(std::decay_t<F>) <=
+                                        alignof(std::aligned_storage_t<N>))> {};
+
 /*
     tasks are functions with a mutable call operator to support moving items through for single
     invocations.
+
+    Callables of up to N bytes are stored inline, larger ones are allocated on the heap. Hot paths
+    whose continuations capture more than the default allows can choose a larger N, at the cost of
+    a larger task.
 */
-template <class>
+template <class, std::size_t N = detail::task_small_size>
 class task;
 
-template <class R, class... Args>
-class task<R(Args...)> {
+template <class R, class... Args, std::size_t N>
+class task<R(Args...), N> {
     template <class F>
     constexpr static bool maybe_empty =
         std::is_pointer<std::decay_t<F>>::value || std::is_member_pointer<std::decay_t<F>>::value ||
@@ -54,9 +134,12 @@ class task<R(Args...)> {
         return false;
     }
 
+    // move_ctor is null for models that are trivially relocatable, which are moved by copying
+    // their size bytes. The empty model has a size of 0.
     struct concept_t {
         void (*dtor)(void*);
         void (*move_ctor)(void*, void*) noexcept;
+        std::size_t size;
         const std::type_info& (*target_type)() noexcept;
         void* (*pointer)(void*) noexcept;
         const void* (*const_pointer)(const void*) noexcept;
@@ -64,13 +147,16 @@ class task<R(Args...)> {
 
     using invoke_t = R (*)(void*, Args...);
 
-    template <class F, bool Small>
+    // D is the deleter of a callable that is not stored inline.
+    template <class F, bool Small, class D = std::default_delete<F>>
     struct model;
 
-    template <class F>
-    struct model<F, true> {
+    template <class F, class D>
+    struct model<F, true, D> {
         template <class G> // for forwarding
         model(G&& f) : _f(std::forward<G>(f)) {}
+        template <class Alloc, class G> // an inline callable does not need the allocator
+        model(std::allocator_arg_t, const Alloc&, G&& f) : _f(std::forward<G>(f)) {}
         model(model&&) noexcept = delete;
 
         static void dtor(void* self) { static_cast<model*>(self)->~model(); }
@@ -94,20 +180,27 @@ class task<R(Args...)> {
         static auto const_pointer(const void* self) noexcept -> const void* {
             return &static_cast<const model*>(self)->_f;
         }
+        static constexpr auto relocate =
+            is_trivially_relocatable<F>::value ? nullptr : move_ctor;
+
 #if defined(__GNUC__) && __GNUC__ < 7 && !defined(__clang__)
         static const concept_t _vtable;
         static const invoke_t _invoke;
 #else
-        static constexpr concept_t _vtable = {dtor, move_ctor, target_type, pointer, const_pointer};
+        static constexpr concept_t _vtable = {dtor,    relocate,     sizeof(F), target_type,
+                                              pointer, const_pointer};
         static constexpr invoke_t _invoke = invoke;
 #endif
         F _f;
     };
 
-    template <class F>
-    struct model<F, false> {
+    template <class F, class D>
+    struct model<F, false, D> {
         template <class G> // for forwarding
         model(G&& f) : _p(std::make_unique<F>(std::forward<G>(f))) {}
+        template <class Alloc, class G>
+        model(std::allocator_arg_t, const Alloc& alloc, G&& f) :
+            _p(D::make(alloc, std::forward<G>(f))) {}
         model(model&&) noexcept = default;
 
         static void dtor(void* self) { static_cast<model*>(self)->~model(); }
@@ -135,20 +228,23 @@ class task<R(Args...)> {
             return static_cast<const model*>(self)->_p.get();
         }
 
+        static constexpr auto relocate =
+            is_trivially_relocatable<std::unique_ptr<F, D>>::value ? nullptr : move_ctor;
+
 #if defined(__GNUC__) && __GNUC__ < 7 && !defined(__clang__)
         static const concept_t _vtable;
         static const invoke_t _invoke;
 #else
-        static constexpr concept_t _vtable = {dtor, move_ctor, target_type, pointer, const_pointer};
+        static constexpr concept_t _vtable = {
+            dtor, relocate, sizeof(std::unique_ptr<F, D>), target_type, pointer, const_pointer};
         static constexpr invoke_t _invoke = invoke;
 #endif
 
-        std::unique_ptr<F> _p;
+        std::unique_ptr<F, D> _p;
     };
 
     // empty (default) vtable
     static void dtor(void*) {}
-    static void move_ctor(void*, void*) noexcept {}
     static auto invoke(void*, Args...) -> R { throw std::bad_function_call(); }
     static auto target_type_() noexcept -> const std::type_info& { return typeid(void); }
     static auto pointer(void*) noexcept -> void* { return nullptr; }
@@ -157,7 +253,7 @@ class task<R(Args...)> {
 #if defined(__GNUC__) && __GNUC__ < 7 && !defined(__clang__)
     static const concept_t _vtable;
 #else
-    static constexpr concept_t _vtable = {dtor, move_ctor, target_type_, pointer, const_pointer};
+    static constexpr concept_t _vtable = {dtor, nullptr, 0, target_type_, pointer, const_pointer};
 #endif
 
     /*
@@ -170,43 +266,78 @@ class task<R(Args...)> {
     the _model, we fill that gap by lifting the _invoke pointer into it from the vtable. This means
     invoke calls require one less indirection.
 
-    The size of the model is big enough for 6 pointers or (2 max aligned object - 2 pointers)
-    (which would typically be 2 pointers). The rational here is that we want the total object size
-    to be a power of 2, for the object but the model store to be large enough to hold 2
-    weak-pointers (which is 4 pointers total), so we give things a little extra room.
+    By default the size of the model is big enough for 6 pointers or (2 max aligned object - 2
+    pointers) (which would typically be 2 pointers). The rational here is that we want the total
+    object size to be a power of 2, for the object but the model store to be large enough to hold
+    2 weak-pointers (which is 4 pointers total), so we give things a little extra room.
     */
 
-    static constexpr size_t max_align = alignof(std::max_align_t);
-    static constexpr size_t small_size =
-        std::max(max_align * 2, sizeof(void*) * 8) - std::max(max_align, sizeof(void*) * 2);
+    static constexpr size_t small_size = N;
 
     const concept_t* _vtable_ptr = &_vtable;
     invoke_t _invoke = invoke;
     std::aligned_storage_t<small_size> _model;
 
+    /*
+        Moves the model of x into this, which must be empty. A trivially relocatable model is
+        copied byte by byte, which avoids an indirect call, and x is left empty so the relocated
+        model is not destroyed twice. Only the bytes of the model are copied, none for an empty x.
+    */
+    void move_from(task& x) noexcept {
+        _vtable_ptr = x._vtable_ptr;
+        _invoke = x._invoke;
+        if (_vtable_ptr->move_ctor) return _vtable_ptr->move_ctor(&x._model, &_model);
+        if (!_vtable_ptr->size) return;
+        std::memcpy(&_model, &x._model, _vtable_ptr->size);
+        x._vtable_ptr = &_vtable;
+        x._invoke = invoke;
+    }
+
+    template <class M, class... Brgs>
+    void emplace(Brgs&&... brgs) {
+        static_assert(task_fits_inline<M, small_size>::value,
+                      "The model of a task must fit its inline buffer.");
+        new (&_model) M(std::forward<Brgs>(brgs)...);
+        _vtable_ptr = &M::_vtable;
+        _invoke = &M::invoke;
+    }
+
 public:
     using result_type = R;
 
     constexpr task() noexcept = default;
     constexpr task(std::nullptr_t) noexcept : task() {}
     task(const task&) = delete;
-    task(task&& x) noexcept : _vtable_ptr(x._vtable_ptr), _invoke(x._invoke) {
-        _vtable_ptr->move_ctor(&x._model, &_model);
-    }
+    task(task&& x) noexcept { move_from(x); }
 
     template <class F, std::enable_if_t<!std::is_same<std::decay_t<F>, task>::value, bool> = true>
     task(F&& f) {
         using small_t = model<std::decay_t<F>, true>;
         using large_t = model<std::decay_t<F>, false>;
-        using model_t = std::conditional_t<(sizeof(small_t) <= small_size) &&
-                                               (alignof(small_t) <= alignof(decltype(_model))),
-                                           small_t, large_t>;
+        using model_t =
+            std::conditional_t<task_fits_inline<small_t, small_size>::value, small_t, large_t>;
 
         if (is_empty(f)) return;
 
-        new (&_model) model_t(std::forward<F>(f));
-        _vtable_ptr = &model_t::_vtable;
-        _invoke = &model_t::invoke;
+        emplace<model_t>(std::forward<F>(f));
+    }
+
+    /*
+        Like task(F&&), but a callable that does not fit inline is allocated with alloc instead of
+        the global operator new. This lets large continuations come from a pool or an arena, such
+        as a std::pmr::polymorphic_allocator.
+    */
+    template <class Alloc, class F>
+    task(std::allocator_arg_t, const Alloc& alloc, F&& f) {
+        using small_t = model<std::decay_t<F>, true>;
+        using large_t =
+            model<std::decay_t<F>, false, detail::allocator_delete<std::decay_t<F>, Alloc>>;
+        using model_t =
+            std::conditional_t<task_fits_inline<small_t, small_size>::value, small_t, large_t>;
+
+        if (is_empty(f)) return;
+
+        emplace<model_t>(std::allocator_arg, alloc, std::forward<F>(f));
     }
 
     ~task() { _vtable_ptr->dtor(&_model); };
@@ -215,9 +346,7 @@ public:
 
     task& operator=(task&& x) noexcept {
         _vtable_ptr->dtor(&_model);
-        _vtable_ptr = x._vtable_ptr;
-        _invoke = x._invoke;
-        _vtable_ptr->move_ctor(&x._model, &_model);
+        move_from(x);
         return *this;
     }
 
@@ -262,50 +391,52 @@ public:
 // In C++17 constexpr implies inline and these definitions are deprecated
 
 #if defined(__GNUC__) && __GNUC__ < 7 && !defined(__clang__)
-template <class R, class... Args>
-const typename task<R(Args...)>::concept_t task<R(Args...)>::_vtable = {
-    dtor, move_ctor, target_type_, pointer, const_pointer};
+template <class R, class... Args, std::size_t N>
+const typename task<R(Args...), N>::concept_t task<R(Args...), N>::_vtable = {
+    dtor, nullptr, 0, target_type_, pointer, const_pointer};
 
-template <class R, class... Args>
-const typename task<R(Args...)>::invoke_t task<R(Args...)>::_invoke = _invoke;
+template <class R, class... Args, std::size_t N>
+const typename task<R(Args...), N>::invoke_t task<R(Args...), N>::_invoke = _invoke;
 #else
-template <class R, class... Args>
-const typename task<R(Args...)>::concept_t task<R(Args...)>::_vtable;
+template <class R, class... Args, std::size_t N>
+const typename task<R(Args...), N>::concept_t task<R(Args...), N>::_vtable;
 #endif
 
 #ifdef _MSC_VER
 
-template <class R, class... Args>
-template <class F>
-const typename task<R(Args...)>::concept_t task<R(Args...)>::model<F, false>::_vtable;
+template <class R, class... Args, std::size_t N>
+template <class F, class D>
+const typename task<R(Args...), N>::concept_t task<R(Args...), N>::model<F, false, D>::_vtable;
 
-template <class R, class... Args>
-template <class F>
-const typename task<R(Args...)>::concept_t task<R(Args...)>::model<F, true>::_vtable;
+template <class R, class... Args, std::size_t N>
+template <class F, class D>
+const typename task<R(Args...), N>::concept_t task<R(Args...), N>::model<F, true, D>::_vtable;
 
 #else
 
 #if defined(__GNUC__) && __GNUC__ < 7 && !defined(__clang__)
 
-template <class R, class... Args>
-template <class F>
-const typename task<R(Args...)>::concept_t task<R(Args...)>::template model<F, false>::_vtable = {
-    dtor, move_ctor, target_type, pointer, const_pointer};
+template <class R, class... Args, std::size_t N>
+template <class F, class D>
+const typename task<R(Args...), N>::concept_t
+    task<R(Args...), N>::template model<F, false, D>::_vtable = {
+        dtor, relocate, sizeof(std::unique_ptr<F, D>), target_type, pointer, const_pointer};
 
-template <class R, class... Args>
-template <class F>
-const typename task<R(Args...)>::concept_t task<R(Args...)>::template model<F, true>::_vtable = {
-    dtor, move_ctor, target_type, pointer, const_pointer};
+template <class R, class... Args, std::size_t N>
+template <class F, class D>
+const typename task<R(Args...), N>::concept_t
+    task<R(Args...), N>::template model<F, true, D>::_vtable = {
+        dtor, relocate, sizeof(F), target_type, pointer, const_pointer};
 
 #else
 
-template <class R, class... Args>
-template <class F>
-const typename task<R(Args...)>::concept_t task<R(Args...)>::model<F, false>::_vtable;
+template <class R, class... Args, std::size_t N>
+template <class F, class D>
+const typename task<R(Args...), N>::concept_t task<R(Args...), N>::model<F, false, D>::_vtable;
 
-template <class R, class... Args>
-template <class F>
-const typename task<R(Args...)>::concept_t task<R(Args...)>::model<F, true>::_vtable;
+template <class R, class... Args, std::size_t N>
+template <class F, class D>
+const typename task<R(Args...), N>::concept_t task<R(Args...), N>::model<F, true, D>::_vtable;
 
 #endif
 
@@ -0,0 +1,191 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+/**************************************************************************************************/
+
+#ifndef STLAB_CONCURRENCY_TASK_GROUP_HPP
+#define STLAB_CONCURRENCY_TASK_GROUP_HPP
+
+#include <stlab/concurrency/default_executor.hpp>
+#include <stlab/concurrency/executor_base.hpp>
+#include <stlab/concurrency/task.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+/**************************************************************************************************/
+
+namespace stlab {
+
+/**************************************************************************************************/
+
+inline namespace v1 {
+
+/**************************************************************************************************/
+
+namespace detail {
+
+/**************************************************************************************************/
+
+class task_group_state {
+    using lock_t = std::unique_lock<std::mutex>;
+
+    std::mutex _mutex;
+    std::condition_variable _ready;
+    std::deque<task<void()>> _pending;
+    std::size_t _outstanding{0}; // pending and running children
+    std::exception_ptr _error;
+
+    void run(task<void()>& f) {
+        std::exception_ptr error;
+        try {
+            f();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        f = nullptr;
+
+        bool done;
+        {
+            lock_t lock{_mutex};
+            if (error && !_error) _error = std::move(error);
+            done = --_outstanding == 0;
+        }
+        if (done) _ready.notify_all();
+    }
+
+public:
+    // Queues f unless limit children are outstanding, returns false if f was not queued.
+    bool push(task<void()>& f, std::size_t limit) {
+        lock_t lock{_mutex};
+        if (_outstanding >= limit) return false;
+        ++_outstanding;
+        _pending.push_back(std::move(f));
+        return true;
+    }
+
+    void run_inline(task<void()>& f) {
+        {
+            lock_t lock{_mutex};
+            ++_outstanding;
+        }
+        run(f);
+    }
+
+    // Runs the oldest pending child, called by the tasks scheduled on the executor.
+    void run_oldest() {
+        task<void()> f;
+        {
+            lock_t lock{_mutex};
+            if (_pending.empty()) return;
+            f = std::move(_pending.front());
+            _pending.pop_front();
+        }
+        run(f);
+    }
+
+    // Runs the newest pending child, returns false if there was none.
+    bool run_newest() {
+        task<void()> f;
+        {
+            lock_t lock{_mutex};
+            if (_pending.empty()) return false;
+            f = std::move(_pending.back());
+            _pending.pop_back();
+        }
+        run(f);
+        return true;
+    }
+
+    std::exception_ptr wait() {
+        while (run_newest()) {}
+
+        bool running;
+        {
+            lock_t lock{_mutex};
+            running = _outstanding != 0;
+        }
+        // The remaining children run on other threads, let the task system replace this one.
+        if (running) {
+            blocking_guard guard;
+            lock_t lock{_mutex};
+            _ready.wait(lock, [&] { return _outstanding == 0; });
+        }
+
+        lock_t lock{_mutex};
+        auto result = _error;
+        _error = nullptr;
+        return result;
+    }
+};
+
+/**************************************************************************************************/
+
+} // namespace detail
+
+/**************************************************************************************************/
+
+/*
+    A scope for fork-join parallelism. run() schedules a child task on the executor and wait()
+    returns once all children have finished, rethrowing the first exception a child threw.
+
+    Instead of blocking, wait() runs the children that have not started yet on the calling
+    thread, newest first, while the executor takes them oldest first. Recursive divide and
+    conquer therefore proceeds without a thread blocked per level. At most limit children are
+    outstanding at a time, run() calls a child directly on the calling thread when the limit is
+    reached. If children are still running on other threads once none is left to take, wait()
+    blocks under a blocking_guard.
+
+    The destructor waits for the children and discards their exceptions.
+*/
+
+class task_group {
+    std::shared_ptr<detail::task_group_state> _state{
+        std::make_shared<detail::task_group_state>()};
+    executor_t _executor;
+    std::size_t _limit;
+
+public:
+    explicit task_group(executor_t executor,
+                        std::size_t limit = std::numeric_limits<std::size_t>::max()) :
+        _executor(std::move(executor)), _limit(limit) {}
+
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    ~task_group() { _state->wait(); }
+
+    template <class F>
+    void run(F&& f) {
+        task<void()> child(std::forward<F>(f));
+        if (!_state->push(child, _limit)) return _state->run_inline(child);
+        _executor([_s = _state] { _s->run_oldest(); });
+    }
+
+    void wait() {
+        if (auto error = _state->wait()) std::rethrow_exception(error);
+    }
+};
+
+/**************************************************************************************************/
+
+} // namespace v1
+
+/**************************************************************************************************/
+
+} // namespace stlab
+
+/**************************************************************************************************/
+
+#endif // STLAB_CONCURRENCY_TASK_GROUP_HPP
+
+/**************************************************************************************************/
@@ -0,0 +1,412 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+/**************************************************************************************************/
+
+#ifndef STLAB_CONCURRENCY_TRACE_HPP
+#define STLAB_CONCURRENCY_TRACE_HPP
+
+#include <stlab/concurrency/config.hpp>
+
+#if STLAB_FEATURE(TASK_SYSTEM_TRACE)
+
+#include <stlab/concurrency/task.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+#endif
+
+/**************************************************************************************************/
+
+/*
+    Tracing of the tasks run by the portable task system. Define STLAB_ENABLE_TASK_SYSTEM_TRACE
+    to compile it in, then record between start_trace() and stop_trace() and write the records
+    with write_chrome_trace() in the Chrome trace event format, which chrome://tracing and
+    Perfetto can load.
+
+    Each thread records into its own ring buffer of STLAB_TRACE_BUFFER_SIZE tasks, older records
+    are overwritten. A record holds the begin and end of a task, its priority, and its origin, the
+    type of the function passed to async(), then(), or recover(), or of the channel process that
+    scheduled it. When a thread exits its buffer keeps its records until another thread reuses
+    it, so a trace includes finished threads while the number of buffers stays bounded by the
+    number of threads that recorded at the same time.
+*/
+
+#ifndef STLAB_TRACE_BUFFER_SIZE
+#define STLAB_TRACE_BUFFER_SIZE 16384
+#endif
+
+/**************************************************************************************************/
+
+namespace stlab {
+
+/**************************************************************************************************/
+
+inline namespace v1 {
+
+/**************************************************************************************************/
+
+namespace detail {
+
+/**************************************************************************************************/
+
+#if STLAB_FEATURE(TASK_SYSTEM_TRACE)
+
+using trace_clock = std::chrono::steady_clock;
+
+inline std::int64_t trace_now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               trace_clock::now().time_since_epoch())
+        .count();
+}
+
+struct trace_record {
+    std::int64_t _begin;
+    std::int64_t _end;
+    const char* _origin;
+    unsigned _priority;
+};
+
+/*
+    A ring buffer written by a single thread and read by any thread without locking. Each slot is
+    guarded by a sequence number that is odd while the slot is written, a reader discards a slot
+    whose sequence number changed while it was read.
+*/
+
+class trace_buffer {
+    static_assert((STLAB_TRACE_BUFFER_SIZE & (STLAB_TRACE_BUFFER_SIZE - 1)) == 0,
+                  "STLAB_TRACE_BUFFER_SIZE must be a power of 2");
+
+    struct slot {
+        std::atomic<std::uint64_t> _sequence{0};
+        std::atomic<std::int64_t> _begin{0};
+        std::atomic<std::int64_t> _end{0};
+        std::atomic<const char*> _origin{nullptr};
+        std::atomic<unsigned> _priority{0};
+    };
+
+    static constexpr std::uint64_t mask() { return STLAB_TRACE_BUFFER_SIZE - 1; }
+
+    std::unique_ptr<slot[]> _slots{new slot[STLAB_TRACE_BUFFER_SIZE]};
+    std::atomic<std::uint64_t> _head{0};
+    std::atomic<std::uint64_t> _first{0}; // records before it belong to an earlier thread
+
+public:
+    const unsigned _id;
+    std::string _name; // guarded by the trace_registry mutex
+
+    trace_buffer(unsigned id, std::string name) : _id(id), _name(std::move(name)) {}
+
+    // Only called by the thread taking the buffer over, while the trace_registry mutex is held.
+    void reuse(std::string name) {
+        _first.store(_head.load(std::memory_order_relaxed), std::memory_order_release);
+        _name = std::move(name);
+    }
+
+    // Only called by the owning thread.
+    void push(const trace_record& x) {
+        auto h = _head.load(std::memory_order_relaxed);
+        auto& s = _slots[h & mask()];
+        s._sequence.store(2 * h + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s._begin.store(x._begin, std::memory_order_relaxed);
+        s._end.store(x._end, std::memory_order_relaxed);
+        s._origin.store(x._origin, std::memory_order_relaxed);
+        s._priority.store(x._priority, std::memory_order_relaxed);
+        s._sequence.store(2 * h + 2, std::memory_order_release);
+        _head.store(h + 1, std::memory_order_release);
+    }
+
+    template <class F>
+    void for_each(F f) const {
+        auto h = _head.load(std::memory_order_acquire);
+        auto first = _first.load(std::memory_order_acquire);
+        for (auto i = std::max(first, h > mask() ? h - mask() - 1 : 0); i < h; ++i) {
+            auto& s = _slots[i & mask()];
+            auto sequence = s._sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * i + 2) continue;
+            trace_record x{s._begin.load(std::memory_order_relaxed),
+                           s._end.load(std::memory_order_relaxed),
+                           s._origin.load(std::memory_order_relaxed),
+                           s._priority.load(std::memory_order_relaxed)};
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s._sequence.load(std::memory_order_relaxed) != sequence) continue;
+            f(x);
+        }
+    }
+};
+
+struct trace_registry {
+    std::mutex _mutex;
+    std::vector<std::shared_ptr<trace_buffer>> _buffers;
+    std::vector<std::shared_ptr<trace_buffer>> _free; // buffers of threads that have exited
+    std::atomic_bool _active{false};
+    std::atomic<std::int64_t> _start{0};
+    std::atomic<std::int64_t> _stop{0};
+};
+
+inline trace_registry& trace_registry_instance() {
+    static trace_registry result;
+    return result;
+}
+
+// The name of the current thread in the trace, set before the thread records its first task.
+inline std::string& this_trace_thread_name() {
+    thread_local std::string result;
+    return result;
+}
+
+/*
+    The buffer is taken when the thread records its first task, from the buffers of exited threads
+    if there is one, and returned when the thread exits.
+*/
+class trace_buffer_lease {
+    std::shared_ptr<trace_buffer> _buffer;
+
+public:
+    trace_buffer_lease() {
+        auto& registry = trace_registry_instance();
+        std::unique_lock<std::mutex> lock{registry._mutex};
+        auto name = this_trace_thread_name();
+        if (!registry._free.empty()) {
+            _buffer = std::move(registry._free.back());
+            registry._free.pop_back();
+            _buffer->reuse(name.empty() ? "thread " + std::to_string(_buffer->_id) :
+                                          std::move(name));
+            return;
+        }
+        auto id = static_cast<unsigned>(registry._buffers.size());
+        _buffer = std::make_shared<trace_buffer>(
+            id, name.empty() ? "thread " + std::to_string(id) : std::move(name));
+        registry._buffers.push_back(_buffer);
+    }
+
+    ~trace_buffer_lease() {
+        auto& registry = trace_registry_instance();
+        std::unique_lock<std::mutex> lock{registry._mutex};
+        registry._free.push_back(std::move(_buffer));
+    }
+
+    trace_buffer_lease(const trace_buffer_lease&) = delete;
+    trace_buffer_lease& operator=(const trace_buffer_lease&) = delete;
+
+    trace_buffer& get() const { return *_buffer; }
+};
+
+inline trace_buffer& this_trace_buffer() {
+    thread_local trace_buffer_lease result;
+    return result.get();
+}
+
+inline bool trace_active() {
+    return trace_registry_instance()._active.load(std::memory_order_relaxed);
+}
+
+inline const char*& this_trace_origin() {
+    thread_local const char* result{nullptr};
+    return result;
+}
+
+// Sets the origin of the current thread for its lifetime.
+class trace_origin_guard {
+    const char* _prior{this_trace_origin()};
+
+public:
+    explicit trace_origin_guard(const char* origin) { this_trace_origin() = origin; }
+    ~trace_origin_guard() { this_trace_origin() = _prior; }
+
+    trace_origin_guard(const trace_origin_guard&) = delete;
+    trace_origin_guard& operator=(const trace_origin_guard&) = delete;
+};
+
+/*
+    Schedules tasks on E with the origin that was active when it was created. A continuation is
+    scheduled by whichever thread makes its future ready, so then() and recover() capture the
+    origin when the continuation is attached.
+*/
+template <class E>
+struct origin_executor {
+    E _executor;
+    const char* _origin;
+
+    template <class F>
+    void operator()(F&& f) {
+        trace_origin_guard origin{_origin};
+        _executor(std::forward<F>(f));
+    }
+};
+
+// Wraps f so its execution is recorded in the trace buffer of the thread running it.
+template <class F>
+auto traced(F&& f, unsigned priority) {
+    return [_f = task<void()>(std::forward<F>(f)), _origin = this_trace_origin(),
+            priority]() mutable {
+        auto begin = trace_now();
+        _f();
+        this_trace_buffer().push(trace_record{begin, trace_now(), _origin, priority});
+    };
+}
+
+inline std::string demangle(const char* name) {
+#if defined(__GNUG__)
+    int status = 0;
+    std::unique_ptr<char, void (*)(void*)> result{
+        abi::__cxa_demangle(name, nullptr, nullptr, &status), std::free};
+    if (status == 0) return result.get();
+#endif
+    return name;
+}
+
+inline void write_json_string(std::ostream& out, const std::string& x) {
+    out << '"';
+    for (auto c : x) {
+        if (c == '"' || c == '\\') out << '\\';
+        if (static_cast<unsigned char>(c) < 0x20) c = ' ';
+        out << c;
+    }
+    out << '"';
+}
+
+#endif
+
+/**************************************************************************************************/
+
+/*
+    Tasks scheduled while an instance is alive are attributed to the type T in the trace.
+*/
+
+template <class T>
+class trace_origin_scope {
+#if STLAB_FEATURE(TASK_SYSTEM_TRACE)
+    trace_origin_guard _origin{typeid(T).name()};
+
+public:
+    trace_origin_scope() {} // user provided so an unused scope does not warn
+#else
+public:
+    trace_origin_scope() {} // user provided so an unused scope does not warn
+#endif
+
+    trace_origin_scope(const trace_origin_scope&) = delete;
+    trace_origin_scope& operator=(const trace_origin_scope&) = delete;
+};
+
+/*
+    Returns an executor that schedules a continuation of type F on executor, attributed to the
+    origin active now, typically set by then(), or else to F. Without tracing it returns executor.
+*/
+
+#if STLAB_FEATURE(TASK_SYSTEM_TRACE)
+
+template <class F, class E>
+auto with_trace_origin(E&& executor) -> origin_executor<std::decay_t<E>> {
+    auto origin = this_trace_origin();
+    return {std::forward<E>(executor), origin ? origin : typeid(F).name()};
+}
+
+#else
+
+template <class F, class E>
+auto with_trace_origin(E&& executor) -> E&& {
+    return std::forward<E>(executor);
+}
+
+#endif
+
+/**************************************************************************************************/
+
+} // namespace detail
+
+/**************************************************************************************************/
+
+#if STLAB_FEATURE(TASK_SYSTEM_TRACE)
+
+// Starts recording, records from an earlier capture are not written.
+inline void start_trace() {
+    auto& registry = detail::trace_registry_instance();
+    registry._start = detail::trace_now();
+    registry._stop = std::numeric_limits<std::int64_t>::max();
+    registry._active = true;
+}
+
+inline void stop_trace() {
+    auto& registry = detail::trace_registry_instance();
+    registry._active = false;
+    registry._stop = detail::trace_now();
+}
+
+/*
+    Writes the tasks that began between start_trace() and stop_trace(), or now if the trace is
+    still running, as complete events in the Chrome trace event format. Threads are named by the
+    task system that owns them.
+*/
+
+inline void write_chrome_trace(std::ostream& out) {
+    auto& registry = detail::trace_registry_instance();
+    const auto start = registry._start.load();
+    const auto stop = registry._stop.load();
+
+    std::vector<std::pair<std::shared_ptr<detail::trace_buffer>, std::string>> buffers;
+    {
+        std::unique_lock<std::mutex> lock{registry._mutex};
+        for (const auto& e : registry._buffers) buffers.emplace_back(e, e->_name);
+    }
+
+    const char* priorities[] = {"high", "medium", "low"};
+    const char* separator = "\n";
+
+    out << "{\"traceEvents\":[";
+    for (const auto& e : buffers) {
+        const auto& buffer = e.first;
+        out << separator << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->_id
+            << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+        detail::write_json_string(out, e.second);
+        out << "}}";
+        separator = ",\n";
+
+        buffer->for_each([&](const detail::trace_record& x) {
+            if (x._begin < start || stop < x._begin) return;
+            out << separator << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->_id
+                << ",\"ts\":" << (x._begin - start) / 1000.0
+                << ",\"dur\":" << (x._end - x._begin) / 1000.0 << ",\"name\":";
+            detail::write_json_string(out, x._origin ? detail::demangle(x._origin) : "task");
+            out << ",\"args\":{\"priority\":\"" << priorities[x._priority % 3] << "\"}}";
+        });
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+#endif
+
+/**************************************************************************************************/
+
+} // namespace v1
+
+/**************************************************************************************************/
+
+} // namespace stlab
+
+/**************************************************************************************************/
+
+#endif // STLAB_CONCURRENCY_TRACE_HPP
+
+/**************************************************************************************************/
@@ -127,26 +127,42 @@ T blocking_get(future<T> x) {
 #if STLAB_TASK_SYSTEM(PORTABLE)
 
     /*
-        Steal tasks from the default executor to help avoid deadlocks. We should also do this for
-        the single threaded emscripten case but that will require adding a queue to steal
-        from.
-
-        If no tasks are available we wait for one tick of the system clock and exponentially
-        back off on the wait as long as no tasks are available.
+        If this is a task system thread the guard lets another thread serve its queue while this
+        one waits, so the guard is only created if the result is not ready yet and the thread only
+        waits.
+
+        Otherwise steal tasks from the default executor to help avoid deadlocks. We should also do
+        this for the single threaded emscripten case but that will require adding a queue to steal
+        from. If no tasks are available we wait for one tick of the system clock and
+        exponentially back off on the wait as long as no tasks are available.
     */
 
-    for (auto backoff{std::chrono::steady_clock::duration::zero()}; true;) {
-        {
-            std::unique_lock<std::mutex> lock{m};
-            if (condition.wait_for(lock, backoff, [&] { return flag; })) break;
-        }
+    auto ready = [&] {
+        std::unique_lock<std::mutex> lock{m};
+        return flag;
+    };
+
+    if (!ready()) {
+        blocking_guard guard;
 
-        if (detail::pts().steal()) {
-            backoff = std::chrono::steady_clock::duration::zero();
+        if (guard.compensated()) {
+            std::unique_lock<std::mutex> lock{m};
+            condition.wait(lock, [&] { return flag; });
         } else {
-            backoff = (backoff == std::chrono::steady_clock::duration::zero()) ?
-                          std::chrono::steady_clock::duration{1} :
-                          backoff * 2;
+            for (auto backoff{std::chrono::steady_clock::duration::zero()}; true;) {
+                {
+                    std::unique_lock<std::mutex> lock{m};
+                    if (condition.wait_for(lock, backoff, [&] { return flag; })) break;
+                }
+
+                if (detail::pts().steal()) {
+                    backoff = std::chrono::steady_clock::duration::zero();
+                } else {
+                    backoff = (backoff == std::chrono::steady_clock::duration::zero()) ?
+                                  std::chrono::steady_clock::duration{1} :
+                                  backoff * 2;
+                }
+            }
         }
     }
 
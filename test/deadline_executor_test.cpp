@@ -0,0 +1,132 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+/**************************************************************************************************/
+
+#include <boost/test/unit_test.hpp>
+
+#include <stlab/concurrency/deadline_executor.hpp>
+#include <stlab/concurrency/default_executor.hpp>
+#include <stlab/concurrency/future.hpp>
+#include <stlab/concurrency/utility.hpp>
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace stlab;
+using namespace std;
+
+namespace {
+
+// Holds the scheduled tasks until they are run by the test.
+struct manual_executor {
+    shared_ptr<vector<task<void()>>> _tasks = make_shared<vector<task<void()>>>();
+
+    void operator()(task<void()> f) const { _tasks->push_back(std::move(f)); }
+
+    void run_all() const {
+        auto tasks = std::move(*_tasks);
+        _tasks->clear();
+        for (auto& f : tasks) f();
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(deadline_scheduler_runs_earliest_deadline_first) {
+    BOOST_TEST_MESSAGE("running deadline_scheduler runs earliest deadline first");
+
+    manual_executor pool;
+    deadline_scheduler scheduler{pool};
+    auto now = deadline_scheduler::clock_type::now();
+
+    vector<int> order;
+    for (int i : {3, 1, 4, 0, 2}) {
+        scheduler.at(now + chrono::hours(i + 1))([&order, i] { order.push_back(i); });
+    }
+    // Equal deadlines run in submission order.
+    scheduler.at(now + chrono::hours(1))([&order] { order.push_back(10); });
+
+    BOOST_REQUIRE_EQUAL(6u, scheduler.size());
+    pool.run_all();
+
+    BOOST_REQUIRE((order == vector<int>{0, 10, 1, 2, 3, 4}));
+    BOOST_REQUIRE_EQUAL(0u, scheduler.misses());
+    BOOST_REQUIRE_EQUAL(0u, scheduler.size());
+}
+
+BOOST_AUTO_TEST_CASE(deadline_scheduler_counts_and_runs_missed_tasks) {
+    BOOST_TEST_MESSAGE("running deadline_scheduler counts and runs missed tasks");
+
+    manual_executor pool;
+    deadline_scheduler scheduler{pool};
+
+    int count = 0;
+    scheduler.at(deadline_scheduler::clock_type::now() - chrono::seconds(1))([&] { ++count; });
+    scheduler.within(chrono::hours(1))([&] { ++count; });
+    pool.run_all();
+
+    BOOST_REQUIRE_EQUAL(2, count);
+    BOOST_REQUIRE_EQUAL(1u, scheduler.misses());
+}
+
+BOOST_AUTO_TEST_CASE(deadline_scheduler_drops_missed_tasks) {
+    BOOST_TEST_MESSAGE("running deadline_scheduler drops missed tasks");
+
+    manual_executor pool;
+    deadline_scheduler scheduler{pool, deadline_policy::drop};
+
+    auto missed = async(scheduler.within(chrono::seconds(-1)), [] { return 1; });
+    auto met = async(scheduler.within(chrono::hours(1)), [] { return 2; });
+    pool.run_all();
+
+    BOOST_REQUIRE_EQUAL(2, *met.get_try());
+    BOOST_REQUIRE_EXCEPTION(missed.get_try(), future_error, [](const auto& e) {
+        return e.code() == future_error_codes::broken_promise;
+    });
+    BOOST_REQUIRE_EQUAL(1u, scheduler.misses());
+}
+
+BOOST_AUTO_TEST_CASE(deadline_scheduler_routes_missed_tasks_to_fallback) {
+    BOOST_TEST_MESSAGE("running deadline_scheduler routes missed tasks to fallback");
+
+    manual_executor pool;
+    manual_executor fallback;
+    deadline_scheduler scheduler{pool, deadline_policy::fallback, fallback};
+
+    int count = 0;
+    scheduler.within(chrono::seconds(-1))([&] { ++count; });
+    pool.run_all();
+
+    BOOST_REQUIRE_EQUAL(0, count);
+    BOOST_REQUIRE_EQUAL(1u, fallback._tasks->size());
+    fallback.run_all();
+    BOOST_REQUIRE_EQUAL(1, count);
+    BOOST_REQUIRE_EQUAL(1u, scheduler.misses());
+}
+
+BOOST_AUTO_TEST_CASE(deadline_scheduler_rejects_fallback_policy_without_fallback) {
+    BOOST_TEST_MESSAGE("running deadline_scheduler rejects fallback policy without fallback");
+
+    manual_executor pool;
+    BOOST_REQUIRE_THROW(deadline_scheduler(pool, deadline_policy::fallback), invalid_argument);
+    BOOST_REQUIRE_THROW(deadline_scheduler(pool, deadline_policy::fallback, executor_t{}),
+                        invalid_argument);
+    BOOST_REQUIRE_NO_THROW(deadline_scheduler(pool, deadline_policy::drop));
+}
+
+BOOST_AUTO_TEST_CASE(deadline_scheduler_with_async_and_then) {
+    BOOST_TEST_MESSAGE("running deadline_scheduler with async and then");
+
+    deadline_scheduler scheduler{default_executor};
+
+    auto f = async(scheduler.within(chrono::seconds(10)), [] { return 20; })
+                 .then(scheduler.within(chrono::seconds(10)), [](int x) { return x + 22; });
+
+    BOOST_REQUIRE_EQUAL(42, blocking_get(std::move(f)));
+    BOOST_REQUIRE_EQUAL(0u, scheduler.misses());
+}
@@ -0,0 +1,129 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+/**************************************************************************************************/
+
+#define STLAB_ENABLE_TASK_SYSTEM_STATISTICS
+
+#include <boost/test/unit_test.hpp>
+
+#include <stlab/concurrency/default_executor.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace stlab;
+using namespace std;
+
+#if STLAB_TASK_SYSTEM(PORTABLE)
+
+namespace {
+void rest() { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+} // namespace
+
+BOOST_AUTO_TEST_CASE(task_system_statistics_count_executed_tasks) {
+    BOOST_TEST_MESSAGE("The statistics of a task system count every executed task");
+
+    const int count = 1'000;
+    atomic_int executed{0};
+
+    stlab::priority_task_system system{task_system_options{2, "statistics"}};
+    for (int n = 0; n != count; ++n) {
+        system.executor()([&] { ++executed; });
+    }
+    while (executed != count) rest();
+
+    // A task is counted just after it returns, so the last one may not be counted yet.
+    auto total = [&] {
+        uint64_t result = 0;
+        for (const auto& e : system.statistics()) result += e._executed;
+        return result;
+    };
+    while (total() != count) rest();
+
+    auto statistics = system.statistics();
+    BOOST_REQUIRE_EQUAL(2u, statistics.size());
+
+    chrono::nanoseconds running{0};
+    for (const auto& e : statistics) {
+        running += e._running;
+        // Every worker looks for work on the other queue before it first parks.
+        BOOST_REQUIRE(e._steals + e._failed_steals != 0);
+        BOOST_REQUIRE(e._depth == (array<size_t, 3>{}));
+    }
+    BOOST_REQUIRE(running.count() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(task_system_statistics_report_queue_depth_by_priority) {
+    BOOST_TEST_MESSAGE("The statistics of a task system report the queue depth by priority");
+
+    stlab::priority_task_system system{task_system_options{1, "statistics"}};
+
+    atomic_bool started{false};
+    atomic_bool release{false};
+    system.executor()([&] {
+        started = true;
+        while (!release) rest();
+    });
+    while (!started) rest();
+
+    system.high_executor()([] {});
+    system.low_executor()([] {});
+    system.low_executor()([] {});
+
+    auto statistics = system.statistics();
+    BOOST_REQUIRE_EQUAL(1u, statistics.size());
+    BOOST_REQUIRE_EQUAL(1u, statistics[0]._depth[0]);
+    BOOST_REQUIRE_EQUAL(0u, statistics[0]._depth[1]);
+    BOOST_REQUIRE_EQUAL(2u, statistics[0]._depth[2]);
+
+    release = true;
+    while (system.statistics()[0]._executed != 4) rest();
+    BOOST_REQUIRE(system.statistics()[0]._depth == (array<size_t, 3>{}));
+}
+
+BOOST_AUTO_TEST_CASE(latency_histogram_percentiles_are_within_the_bucket_precision) {
+    BOOST_TEST_MESSAGE("Percentiles of a latency histogram are at most 1/16 above the recorded value");
+
+    latency_histogram histogram;
+    for (int n = 1; n <= 1000; ++n) histogram.record(chrono::microseconds(n));
+
+    BOOST_REQUIRE_EQUAL(1000u, histogram.count());
+    for (auto p : {0.5, 0.9, 0.99, 1.0}) {
+        auto expected = chrono::nanoseconds(chrono::microseconds(static_cast<int>(p * 1000)));
+        auto reported = histogram.percentile(p);
+        BOOST_REQUIRE(expected <= reported);
+        BOOST_REQUIRE(reported <= expected + expected / 16);
+    }
+
+    for (std::size_t b = 0; b + 1 != latency_histogram::size(); ++b) {
+        BOOST_REQUIRE_EQUAL(b, latency_histogram::bucket(latency_histogram::upper_bound(b)));
+        BOOST_REQUIRE_EQUAL(b + 1,
+                            latency_histogram::bucket(latency_histogram::upper_bound(b) +
+                                                      chrono::nanoseconds(1)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(task_system_records_queue_delay_by_priority) {
+    BOOST_TEST_MESSAGE("A task system records the queueing delay of tasks by priority");
+
+    stlab::priority_task_system system{task_system_options{2, "delay"}};
+
+    atomic_int executed{0};
+    for (int n = 0; n != 10; ++n) system.high_executor()([&] { ++executed; });
+    for (int n = 0; n != 20; ++n) system.low_executor()([&] { ++executed; });
+    while (executed != 30) rest();
+
+    auto delay = system.reset_queue_delay();
+    BOOST_REQUIRE_EQUAL(10u, delay[0].count());
+    BOOST_REQUIRE_EQUAL(0u, delay[1].count());
+    BOOST_REQUIRE_EQUAL(20u, delay[2].count());
+    BOOST_REQUIRE(delay[2].percentile(0.5) <= delay[2].percentile(0.99));
+
+    for (const auto& e : system.queue_delay()) BOOST_REQUIRE_EQUAL(0u, e.count());
+}
+
+#endif
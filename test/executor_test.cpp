@@ -9,7 +9,9 @@
 #include <boost/test/unit_test.hpp>
 
 #include <stlab/concurrency/default_executor.hpp>
+#include <stlab/concurrency/future.hpp>
 #include <stlab/concurrency/serial_queue.hpp>
+#include <stlab/concurrency/utility.hpp>
 
 #include <array>
 #include <cmath>
@@ -334,3 +336,692 @@ BOOST_AUTO_TEST_CASE(MeasureTiming) {
         rest();
     }
 }
+
+BOOST_AUTO_TEST_CASE(executor_t_is_a_copyable_executor) {
+    BOOST_TEST_MESSAGE("executor_t copies, moves, and calls the executor it holds");
+
+    executor_t empty;
+    BOOST_REQUIRE(!empty);
+    BOOST_REQUIRE(empty == nullptr);
+    BOOST_REQUIRE_THROW(empty([] {}), bad_function_call);
+
+    auto calls = make_shared<int>(0);
+    executor_t small = [calls](task<void()> f) {
+        ++*calls;
+        f();
+    };
+    auto copy = small;
+    BOOST_REQUIRE(copy != nullptr);
+    int ran = 0;
+    copy([&] { ++ran; });
+    small([&] { ++ran; });
+    BOOST_REQUIRE_EQUAL(2, *calls);
+    BOOST_REQUIRE_EQUAL(2, ran);
+    BOOST_REQUIRE_EQUAL(3, calls.use_count());
+
+    // Larger executors are held on the heap and copied as values.
+    struct large {
+        array<char, 128> _data{};
+        int _calls{0};
+
+        void operator()(task<void()> f) {
+            ++_calls;
+            f();
+        }
+    };
+    executor_t a = large{};
+    a([] {});
+    auto b = a;
+    b([] {});
+    auto c = std::move(b);
+    c([] {});
+    a = c;
+    a([] {});
+
+    executor_t moved = std::move(copy);
+    moved([&] { ++ran; });
+    BOOST_REQUIRE_EQUAL(3, ran);
+
+    executor_t standard = default_executor;
+    atomic_bool done{false};
+    standard([&] { done = true; });
+    while (!done) rest();
+}
+
+BOOST_AUTO_TEST_CASE(executor_t_is_empty_once_moved_from) {
+    BOOST_TEST_MESSAGE("A moved from executor_t is empty, for small and large executors");
+
+    auto calls = make_shared<int>(0);
+    executor_t small = [calls](task<void()> f) { f(); };
+    executor_t large = [calls, padding = array<char, 128>{}](task<void()> f) { f(); };
+
+    executor_t moved_small = std::move(small);
+    executor_t moved_large = std::move(large);
+    BOOST_REQUIRE(!small);
+    BOOST_REQUIRE(!large);
+    BOOST_REQUIRE(moved_small && moved_large);
+    BOOST_REQUIRE_THROW(small([] {}), bad_function_call);
+    BOOST_REQUIRE_THROW(large([] {}), bad_function_call);
+    BOOST_REQUIRE_EQUAL(3, calls.use_count());
+
+    executor_t assigned;
+    assigned = std::move(moved_small);
+    BOOST_REQUIRE(!moved_small);
+    assigned = std::move(moved_large);
+    BOOST_REQUIRE(!moved_large);
+    BOOST_REQUIRE_EQUAL(2, calls.use_count());
+
+    int ran = 0;
+    assigned([&] { ++ran; });
+    BOOST_REQUIRE_EQUAL(1, ran);
+
+    // A moved from executor_t may be assigned to again.
+    small = assigned;
+    small([&] { ++ran; });
+    BOOST_REQUIRE_EQUAL(2, ran);
+}
+
+#if STLAB_TASK_SYSTEM(PORTABLE)
+
+BOOST_AUTO_TEST_CASE(chase_lev_deque_owner_is_lifo_and_thieves_are_fifo) {
+    BOOST_TEST_MESSAGE("The owner pops LIFO, thieves steal FIFO");
+
+    stlab::detail::chase_lev_deque<int> q{2};
+    for (int i = 0; i != 10; ++i) q.push(i); // forces the buffer to grow
+
+    int x = -1;
+    BOOST_REQUIRE(q.steal(x));
+    BOOST_REQUIRE_EQUAL(0, x);
+    BOOST_REQUIRE(q.pop(x));
+    BOOST_REQUIRE_EQUAL(9, x);
+    BOOST_REQUIRE(q.steal(x));
+    BOOST_REQUIRE_EQUAL(1, x);
+
+    int count = 0;
+    while (q.pop(x)) ++count;
+    BOOST_REQUIRE_EQUAL(7, count);
+    BOOST_REQUIRE(q.empty());
+    BOOST_REQUIRE(!q.steal(x));
+}
+
+BOOST_AUTO_TEST_CASE(chase_lev_deque_delivers_each_item_exactly_once) {
+    BOOST_TEST_MESSAGE("Concurrent pops and steals deliver each item exactly once");
+
+    const int count = 100'000;
+    stlab::detail::chase_lev_deque<int> q;
+    vector<atomic_int> seen(count);
+    atomic_bool pushing{true};
+
+    auto thief = [&] {
+        int x;
+        while (pushing || !q.empty()) {
+            if (q.steal(x)) ++seen[x];
+        }
+    };
+
+    thread t1{thief};
+    thread t2{thief};
+
+    int x;
+    for (int i = 0; i != count; ++i) {
+        q.push(i);
+        if ((i % 3 == 0) && q.pop(x)) ++seen[x];
+    }
+    while (q.pop(x)) ++seen[x];
+    pushing = false;
+
+    t1.join();
+    t2.join();
+
+    for (const auto& e : seen) BOOST_REQUIRE_EQUAL(1, e.load());
+}
+
+BOOST_AUTO_TEST_CASE(work_stealing_queue_promotes_the_oldest_aged_task) {
+    BOOST_TEST_MESSAGE("The oldest low priority task runs first once it has waited long enough");
+
+    stlab::detail::work_stealing_queue q;
+    q.set_aging(chrono::milliseconds(1));
+
+    vector<int> order;
+    q.push_local([&] { order.push_back(20); }, 2);
+    q.push_local([&] { order.push_back(21); }, 2);
+    this_thread::sleep_for(chrono::milliseconds(5));
+    q.push_local([&] { order.push_back(0); }, 0);
+    q.push_local([&] { order.push_back(22); }, 2);
+
+    task<void()> f;
+    stlab::detail::submission s;
+    while (q.try_pop(f, s)) f();
+
+    // The two aged tasks are promoted oldest first, the rest run by priority and LIFO.
+    BOOST_REQUIRE((order == vector<int>{20, 21, 0, 22}));
+}
+
+BOOST_AUTO_TEST_CASE(work_stealing_task_system_executes_all_tasks) {
+    BOOST_TEST_MESSAGE("The work stealing task system executes all tasks");
+
+    const int count = 10'000;
+    atomic_int executed{0};
+    {
+        stlab::detail::priority_task_system<stlab::detail::work_stealing_queue> system;
+
+        for (int i = 0; i != count; ++i) {
+            switch (i % 3) {
+                case 0:
+                    system.execute<0>([&] { ++executed; });
+                    break;
+                case 1:
+                    system.execute<1>([&] { ++executed; });
+                    break;
+                default:
+                    system.execute<2>([&] { ++executed; });
+                    break;
+            }
+        }
+
+        while (executed != count) rest();
+    }
+    BOOST_REQUIRE_EQUAL(count, executed.load());
+}
+
+namespace {
+
+template <class System>
+struct fan_out_task {
+    System& _system;
+    atomic_int& _remaining;
+    int _depth;
+
+    void operator()() const {
+        if (_depth != 0) {
+            _system.template execute<1>(fan_out_task{_system, _remaining, _depth - 1});
+            _system.template execute<1>(fan_out_task{_system, _remaining, _depth - 1});
+        }
+        --_remaining;
+    }
+};
+
+template <class Queue>
+double measure_fan_out(stlab::task_placement placement) {
+    const int depth = 15;
+    atomic_int remaining{(1 << (depth + 1)) - 1};
+
+    stlab::detail::priority_task_system<Queue> system{task_system_options{
+        stlab::detail::queue_size(), "fan_out", placement, idle_policy::park()}};
+
+    auto start = chrono::high_resolution_clock::now();
+    system.template execute<1>(
+        fan_out_task<decltype(system)>{system, remaining, depth});
+    while (remaining != 0) this_thread::yield();
+    auto stop = chrono::high_resolution_clock::now();
+
+    return chrono::duration<double>(stop - start).count();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(measure_worker_local_placement) {
+    BOOST_TEST_MESSAGE("Measure worker local against round robin task placement");
+
+    using stlab::detail::notification_queue;
+    using stlab::detail::work_stealing_queue;
+
+    cout << "\nFan out, notification_queue, round robin:  "
+         << measure_fan_out<notification_queue>(task_placement::round_robin) << "s\n";
+    cout << "Fan out, notification_queue, worker local: "
+         << measure_fan_out<notification_queue>(task_placement::worker_local) << "s\n";
+    cout << "Fan out, work_stealing_queue, round robin:  "
+         << measure_fan_out<work_stealing_queue>(task_placement::round_robin) << "s\n";
+    cout << "Fan out, work_stealing_queue, worker local: "
+         << measure_fan_out<work_stealing_queue>(task_placement::worker_local) << "s\n";
+}
+
+namespace {
+
+// The same callable is measured with and without the trivially relocatable fast path.
+template <bool Relocatable>
+struct counting_task {
+    atomic_int* _count;
+    void* _padding[3];
+
+    void operator()() const { ++*_count; }
+};
+
+} // namespace
+
+namespace stlab {
+inline namespace v1 {
+
+template <>
+struct is_trivially_relocatable<counting_task<false>> : std::false_type {};
+
+} // namespace v1
+} // namespace stlab
+
+namespace {
+
+template <class F>
+double measure_push_pop(F f) {
+    const int count = 1'000'000;
+    const int batch = 64;
+    stlab::detail::notification_queue queue;
+
+    auto start = chrono::high_resolution_clock::now();
+    for (int n = 0; n != count; n += batch) {
+        for (int k = 0; k != batch; ++k) queue.push(f, k % 3);
+        for (int k = 0; k != batch; ++k) {
+            task<void()> t;
+            stlab::detail::submission s;
+            queue.pop(t, s);
+            t();
+        }
+    }
+    auto stop = chrono::high_resolution_clock::now();
+
+    return count / chrono::duration<double>(stop - start).count() / 1e6;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(measure_notification_queue_task_relocation) {
+    BOOST_TEST_MESSAGE("Measure notification_queue push and pop with relocated tasks");
+
+    atomic_int count{0};
+    auto moved = measure_push_pop(counting_task<false>{&count, {}});
+    auto relocated = measure_push_pop(counting_task<true>{&count, {}});
+    BOOST_REQUIRE_EQUAL(2'000'000, count.load());
+
+    cout << "\nnotification_queue push/pop, moved through the vtable: " << moved << "M/s\n";
+    cout << "notification_queue push/pop, trivially relocated:     " << relocated << "M/s\n";
+}
+
+BOOST_AUTO_TEST_CASE(bulk_submitted_tasks_are_executed) {
+    BOOST_TEST_MESSAGE("Tasks submitted in bulk are executed");
+
+    const int count = 1'000;
+    atomic_int executed{0};
+
+    vector<task<void()>> tasks;
+    for (int i = 0; i != count; ++i) tasks.emplace_back([&] { ++executed; });
+
+    default_executor.bulk(begin(tasks), end(tasks));
+    while (executed != count) rest();
+
+    tasks.resize(1);
+    tasks[0] = [&] { ++executed; };
+    high_executor.bulk(begin(tasks), end(tasks));
+    while (executed != count + 1) rest();
+
+    BOOST_REQUIRE_EQUAL(count + 1, executed.load());
+}
+
+
+namespace {
+
+double measure_hand_off(stlab::idle_policy idle) {
+    using namespace stlab::detail;
+
+    const int count = 2'000;
+    chrono::steady_clock::duration latency{};
+
+    stlab::detail::priority_task_system<notification_queue> system{
+        task_system_options{queue_size(), "hand_off", task_placement::round_robin, idle}};
+
+    for (int n = 0; n != count; ++n) {
+        atomic_bool done{false};
+        auto submitted = chrono::steady_clock::now();
+        system.execute<1>([&] {
+            latency += chrono::steady_clock::now() - submitted;
+            done = true;
+        });
+        while (!done) this_thread::yield();
+    }
+
+    return chrono::duration<double, micro>(latency).count() / count;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(measure_idle_policy_hand_off_latency) {
+    BOOST_TEST_MESSAGE("Measure the hand-off latency for each idle policy");
+
+    cout << "\nHand-off latency, park:            " << measure_hand_off(idle_policy::park())
+         << "us\n";
+    cout << "Hand-off latency, spin then park:  " << measure_hand_off(idle_policy::adaptive(1024, 0))
+         << "us\n";
+    cout << "Hand-off latency, spin/yield/park: " << measure_hand_off(idle_policy::adaptive())
+         << "us\n";
+}
+
+namespace {
+
+/*
+    Saturates a task system of two workers with chains of high priority tasks that resubmit
+    themselves, then measures how long low priority tasks wait to run. A wait is cut off at
+    `limit` and counted as starved.
+*/
+template <class Queue>
+pair<double, int> measure_low_priority_wait(chrono::nanoseconds aging,
+                                            chrono::milliseconds limit) {
+    using namespace stlab::detail;
+    using system_t = stlab::detail::priority_task_system<Queue>;
+
+    system_t system{task_system_options{2, "aging", task_placement::round_robin,
+                                        idle_policy::park(), thread_affinity::none, aging}};
+
+    atomic_bool stop{false};
+    atomic_int live{0};
+
+    struct chain {
+        system_t* _system;
+        atomic_bool* _stop;
+        atomic_int* _live;
+
+        void operator()() const {
+            auto until = chrono::steady_clock::now() + chrono::microseconds(20);
+            while (chrono::steady_clock::now() < until) {}
+            if (*_stop) {
+                --*_live;
+                return;
+            }
+            _system->template execute<0>(*this);
+        }
+    };
+
+    for (int n = 0; n != 64; ++n) {
+        ++live;
+        system.template execute<0>(chain{&system, &stop, &live});
+    }
+    this_thread::sleep_for(chrono::milliseconds(5));
+
+    const int trials = 5;
+    chrono::steady_clock::duration longest{};
+    int starved = 0;
+    for (int n = 0; n != trials; ++n) {
+        auto ran = make_shared<atomic_bool>(false);
+        auto submitted = chrono::steady_clock::now();
+        system.template execute<2>([ran] { *ran = true; });
+
+        while (!*ran && chrono::steady_clock::now() - submitted < limit) rest();
+        if (!*ran) ++starved;
+        longest = max(longest, chrono::steady_clock::now() - submitted);
+    }
+
+    stop = true;
+    while (live) rest();
+
+    return {chrono::duration<double, milli>(longest).count(), starved};
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(measure_low_priority_wait_under_saturation) {
+    BOOST_TEST_MESSAGE("Measure the wait of low priority tasks behind saturating high priority work");
+
+    const auto limit = chrono::milliseconds(100);
+    const auto aging = chrono::milliseconds(1);
+
+    auto strict = measure_low_priority_wait<stlab::detail::notification_queue>(chrono::nanoseconds(0), limit);
+    auto aged = measure_low_priority_wait<stlab::detail::notification_queue>(aging, limit);
+    auto aged_stealing = measure_low_priority_wait<stlab::detail::work_stealing_queue>(aging, limit);
+
+    cout << "\nLow priority wait, strict priority:                " << strict.first << "ms, "
+         << strict.second << " of 5 starved\n";
+    cout << "Low priority wait, aging 1ms, notification_queue:  " << aged.first << "ms, "
+         << aged.second << " of 5 starved\n";
+    cout << "Low priority wait, aging 1ms, work_stealing_queue: " << aged_stealing.first << "ms, "
+         << aged_stealing.second << " of 5 starved\n";
+
+    BOOST_REQUIRE_EQUAL(0, aged.second);
+    BOOST_REQUIRE_EQUAL(0, aged_stealing.second);
+}
+
+BOOST_AUTO_TEST_CASE(task_system_instances_run_tasks_on_their_own_threads) {
+    BOOST_TEST_MESSAGE("Each task system instance runs tasks on its own named threads");
+
+    stlab::priority_task_system requests{task_system_options{2, "requests"}};
+    stlab::priority_task_system batch{task_system_options{1, "batch"}};
+
+    BOOST_REQUIRE_EQUAL(2u, requests.size());
+    BOOST_REQUIRE_EQUAL(1u, batch.size());
+
+    auto on_system = [](const void* system) {
+        return [system] { return stlab::detail::this_worker()._system == system; };
+    };
+
+    BOOST_REQUIRE(blocking_get(async(requests.executor(), on_system(&requests))));
+    BOOST_REQUIRE(blocking_get(async(requests.high_executor(), on_system(&requests))));
+    BOOST_REQUIRE(blocking_get(async(batch.low_executor(), on_system(&batch))));
+    BOOST_REQUIRE(!blocking_get(async(default_executor, on_system(&batch))));
+
+#if STLAB_FEATURE(THREAD_NAME_POSIX)
+    auto name = blocking_get(async(batch.executor(), [] {
+        char result[16]{};
+        pthread_getname_np(pthread_self(), result, sizeof(result));
+        return string(result);
+    }));
+    BOOST_REQUIRE_EQUAL("batch", name);
+#endif
+}
+
+#if STLAB_FEATURE(THREAD_AFFINITY_LINUX)
+
+namespace {
+
+vector<int> current_thread_affinity() {
+    vector<int> result;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    sched_getaffinity(0, sizeof(set), &set);
+    for (int cpu = 0; cpu != CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) result.push_back(cpu);
+    }
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(task_system_workers_are_pinned_to_cpus) {
+    BOOST_TEST_MESSAGE("Workers of a task system with cpu affinity run on a single cpu");
+
+    auto allowed = current_thread_affinity();
+
+    stlab::priority_task_system system{
+        task_system_options{2, "pinned", task_placement::round_robin, idle_policy::park(),
+                            thread_affinity::cpu}};
+
+    for (int n = 0; n != 10; ++n) {
+        auto cpus = blocking_get(async(system.executor(), current_thread_affinity));
+        BOOST_REQUIRE_EQUAL(1u, cpus.size());
+        BOOST_REQUIRE(find(begin(allowed), end(allowed), cpus[0]) != end(allowed));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(task_system_workers_are_restricted_to_a_numa_node) {
+    BOOST_TEST_MESSAGE("Workers of a task system with numa_node affinity run on one node");
+
+    auto topology = stlab::detail::cpu_topology();
+    BOOST_REQUIRE(!topology.empty());
+
+    stlab::priority_task_system system{
+        task_system_options{2, "numa", task_placement::round_robin, idle_policy::park(),
+                            thread_affinity::numa_node}};
+
+    for (int n = 0; n != 10; ++n) {
+        auto cpus = blocking_get(async(system.executor(), current_thread_affinity));
+        BOOST_REQUIRE(find(begin(topology), end(topology), cpus) != end(topology));
+    }
+}
+
+#endif
+
+BOOST_AUTO_TEST_CASE(blocking_get_on_a_worker_does_not_starve_its_task_system) {
+    BOOST_TEST_MESSAGE("A worker blocked in blocking_get is compensated by another thread");
+
+    stlab::priority_task_system system{task_system_options{1, "blocking"}};
+    auto executor = system.executor();
+
+    auto result = async(executor, [executor] {
+        return blocking_get(async(executor, [] { return 42; }));
+    });
+
+    BOOST_REQUIRE_EQUAL(42, blocking_get(result));
+}
+
+BOOST_AUTO_TEST_CASE(blocking_get_reuses_compensating_threads) {
+    BOOST_TEST_MESSAGE("blocking_get compensates only when it blocks and reuses parked threads");
+
+    atomic_int started{0};
+    task_system_options options{1, "reuse"};
+    options._on_thread_start = [&](unsigned) { ++started; };
+
+    stlab::priority_task_system system{std::move(options)};
+    auto executor = system.executor();
+
+    // A ready result does not block, so no thread is started for it.
+    BOOST_REQUIRE_EQUAL(42, blocking_get(async(executor, [] {
+        return blocking_get(make_ready_future(42, immediate_executor));
+    })));
+    BOOST_REQUIRE_EQUAL(1, started.load());
+
+    for (int n = 0; n != 10; ++n) {
+        BOOST_REQUIRE_EQUAL(n, blocking_get(async(executor, [executor, n] {
+            return blocking_get(async(executor, [n] { return n; }));
+        })));
+        // Give the compensating thread time to retire before the worker blocks again.
+        this_thread::sleep_for(chrono::milliseconds(20));
+    }
+    BOOST_REQUIRE_EQUAL(2, started.load());
+}
+
+BOOST_AUTO_TEST_CASE(blocking_guard_keeps_the_task_system_running) {
+    BOOST_TEST_MESSAGE("Tasks run while all workers are blocked under a blocking_guard");
+
+    const unsigned count = 2;
+    stlab::priority_task_system system{task_system_options{count, "guarded"}};
+
+    mutex m;
+    condition_variable ready;
+    unsigned blocked = 0;
+    bool released = false;
+    atomic_int finished{0};
+
+    for (unsigned n = 0; n != count; ++n) {
+        system.executor()([&] {
+            blocking_guard guard;
+            unique_lock<mutex> lock{m};
+            ++blocked;
+            ready.notify_all();
+            ready.wait(lock, [&] { return released; });
+            ++finished;
+        });
+    }
+
+    {
+        unique_lock<mutex> lock{m};
+        ready.wait(lock, [&] { return blocked == count; });
+    }
+
+    // Every worker is blocked, so this task only runs on a compensating thread.
+    system.executor()([&] {
+        {
+            unique_lock<mutex> lock{m};
+            released = true;
+        }
+        ready.notify_all();
+    });
+
+    while (finished != count) rest();
+}
+
+BOOST_AUTO_TEST_CASE(task_system_calls_thread_hooks) {
+    BOOST_TEST_MESSAGE("Thread hooks are called on the worker threads of a task system");
+
+    static thread_local int resource = 0;
+    atomic_int started{0};
+    atomic_int stopped{0};
+    atomic_int idle{0};
+    atomic_int missing{0};
+
+    {
+        task_system_options options{2, "hooks"};
+        options._on_thread_start = [&](unsigned i) {
+            resource = i < 2 ? 1 : 0;
+            ++started;
+        };
+        options._on_thread_stop = [&](unsigned) {
+            resource = 0;
+            ++stopped;
+        };
+        options._on_idle = [&](unsigned) { ++idle; };
+
+        stlab::priority_task_system system{std::move(options)};
+        vector<future<void>> results;
+        for (int n = 0; n != 100; ++n) {
+            results.push_back(async(system.executor(), [&] {
+                if (resource != 1) ++missing;
+            }));
+        }
+        for (auto& e : results) blocking_get(std::move(e));
+    }
+
+    BOOST_REQUIRE_EQUAL(2, started.load());
+    BOOST_REQUIRE_EQUAL(2, stopped.load());
+    BOOST_REQUIRE_GT(idle.load(), 0);
+    BOOST_REQUIRE_EQUAL(0, missing.load());
+}
+
+BOOST_AUTO_TEST_CASE(io_executor_runs_blocking_tasks_concurrently) {
+    BOOST_TEST_MESSAGE("Blocking tasks on io_executor do not wait for each other");
+
+    const int count = 32;
+    vector<future<void>> results;
+
+    auto start = chrono::steady_clock::now();
+    for (int n = 0; n != count; ++n) {
+        results.push_back(
+            async(io_executor, [] { this_thread::sleep_for(chrono::milliseconds(50)); }));
+    }
+    for (auto& e : results) blocking_get(std::move(e));
+
+    // Run one after another the tasks would take 1.6s.
+    BOOST_REQUIRE(chrono::steady_clock::now() - start < chrono::milliseconds(800));
+
+    auto hop = async(io_executor, [] { return this_thread::get_id(); })
+                   .then(default_executor,
+                         [](thread::id io) { return io != this_thread::get_id(); });
+    BOOST_REQUIRE(blocking_get(std::move(hop)));
+}
+
+BOOST_AUTO_TEST_CASE(elastic_task_system_is_bounded_and_reaps_idle_threads) {
+    BOOST_TEST_MESSAGE("An elastic_task_system stays below its maximum and ends idle threads");
+
+    stlab::elastic_task_system system{
+        elastic_task_system_options{3, chrono::milliseconds(20), "elastic"}};
+
+    atomic_int current{0};
+    atomic_int peak{0};
+    vector<future<void>> results;
+    for (int n = 0; n != 12; ++n) {
+        results.push_back(async(system.executor(), [&] {
+            auto c = ++current;
+            auto p = peak.load();
+            while (p < c && !peak.compare_exchange_weak(p, c)) {}
+            this_thread::sleep_for(chrono::milliseconds(5));
+            --current;
+        }));
+    }
+    for (auto& e : results) blocking_get(std::move(e));
+
+    BOOST_REQUIRE_LE(peak.load(), 3);
+    BOOST_REQUIRE_LE(system.size(), 3u);
+
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(5);
+    while (system.size() != 0 && chrono::steady_clock::now() < deadline) rest();
+    BOOST_REQUIRE_EQUAL(0u, system.size());
+
+    // Threads are started again after they were reaped.
+    BOOST_REQUIRE_EQUAL(42, blocking_get(async(system.executor(), [] { return 42; })));
+}
+
+#endif
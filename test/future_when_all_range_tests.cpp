@@ -398,6 +398,43 @@ BOOST_AUTO_TEST_CASE(future_when_all_range_with_mutable_void_task) {
 }
 
 
+namespace {
+struct bulk_executor {
+    std::atomic_int& _bulk_calls;
+    std::atomic_int& _bulk_tasks;
+
+    void operator()(stlab::task<void()> f) const { stlab::default_executor(std::move(f)); }
+
+    template <typename I>
+    void bulk(I first, I last) const {
+        ++_bulk_calls;
+        for (; first != last; ++first) {
+            ++_bulk_tasks;
+            stlab::default_executor(std::move(*first));
+        }
+    }
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(future_when_all_range_with_ready_futures_uses_bulk_execute) {
+    BOOST_TEST_MESSAGE("future when all range with ready futures uses bulk execute");
+
+    std::atomic_int bulk_calls{0};
+    std::atomic_int bulk_tasks{0};
+
+    std::vector<future<int>> futures;
+    for (int i = 0; i != 10; ++i) futures.push_back(make_ready_future(i, immediate_executor));
+
+    auto sut = when_all(bulk_executor{bulk_calls, bulk_tasks},
+                        [](std::vector<int> v) { return std::accumulate(v.begin(), v.end(), 0); },
+                        std::make_pair(futures.begin(), futures.end()));
+
+    BOOST_REQUIRE_EQUAL(45, stlab::blocking_get(sut));
+    BOOST_REQUIRE_EQUAL(1, bulk_calls);
+    BOOST_REQUIRE_EQUAL(10, bulk_tasks);
+}
+
+
 // ----------------------------------------------------------------------------
 //                             Error cases
 // ----------------------------------------------------------------------------
@@ -0,0 +1,145 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+/**************************************************************************************************/
+
+#include <boost/test/unit_test.hpp>
+
+#include <stlab/concurrency/future.hpp>
+#include <stlab/concurrency/group_executor.hpp>
+#include <stlab/concurrency/utility.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace stlab;
+using namespace std;
+
+namespace {
+
+// Holds the scheduled tasks until they are run by the test, one at a time.
+struct manual_executor {
+    shared_ptr<vector<task<void()>>> _tasks = make_shared<vector<task<void()>>>();
+
+    void operator()(task<void()> f) const { _tasks->push_back(std::move(f)); }
+
+    bool run_one() const {
+        if (_tasks->empty()) return false;
+        auto f = std::move(_tasks->front());
+        _tasks->erase(_tasks->begin());
+        f();
+        return true;
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(group_scheduler_shares_by_weight) {
+    BOOST_TEST_MESSAGE("running group_scheduler shares by weight");
+
+    manual_executor pool;
+    group_scheduler scheduler{pool};
+    auto heavy = scheduler.make_group_executor(3);
+    auto light = scheduler.make_group_executor(1);
+
+    vector<char> order;
+    for (int i = 0; i != 8; ++i) light([&] { order.push_back('l'); });
+    for (int i = 0; i != 8; ++i) heavy([&] { order.push_back('h'); });
+
+    BOOST_REQUIRE_EQUAL(8u, light.statistics()._queued);
+
+    for (int i = 0; i != 8; ++i) pool.run_one();
+    BOOST_REQUIRE_EQUAL(6, count(order.begin(), order.end(), 'h'));
+
+    while (pool.run_one()) {}
+    BOOST_REQUIRE_EQUAL(16u, order.size());
+
+    auto s = heavy.statistics();
+    BOOST_REQUIRE_EQUAL(0u, s._queued);
+    BOOST_REQUIRE_EQUAL(0u, s._running);
+    BOOST_REQUIRE_EQUAL(8u, s._completed);
+}
+
+BOOST_AUTO_TEST_CASE(group_scheduler_idle_group_gains_no_credit) {
+    BOOST_TEST_MESSAGE("running group_scheduler idle group gains no credit");
+
+    manual_executor pool;
+    group_scheduler scheduler{pool};
+    auto busy = scheduler.make_group_executor();
+    auto idle = scheduler.make_group_executor();
+
+    vector<char> order;
+    for (int i = 0; i != 8; ++i) busy([&] { order.push_back('b'); });
+    for (int i = 0; i != 4; ++i) pool.run_one();
+
+    // The returning group alternates with the busy one instead of catching up.
+    for (int i = 0; i != 4; ++i) idle([&] { order.push_back('i'); });
+    while (pool.run_one()) {}
+
+    BOOST_REQUIRE((order == vector<char>{'b', 'b', 'b', 'b', 'i', 'b', 'i', 'b', 'i', 'b', 'i',
+                                         'b'}));
+}
+
+BOOST_AUTO_TEST_CASE(group_scheduler_limits_inflight) {
+    BOOST_TEST_MESSAGE("running group_scheduler limits inflight");
+
+    auto limited = make_group_executor(1, 2);
+    auto other = make_group_executor();
+
+    atomic_int current{0};
+    atomic_int peak{0};
+    vector<future<void>> results;
+
+    for (int i = 0; i != 16; ++i) {
+        results.push_back(async(limited, [&] {
+            auto n = ++current;
+            auto p = peak.load();
+            while (p < n && !peak.compare_exchange_weak(p, n)) {}
+            this_thread::sleep_for(chrono::milliseconds(2));
+            --current;
+        }));
+    }
+    auto x = async(other, [] { return 42; });
+
+    BOOST_REQUIRE_EQUAL(42, blocking_get(std::move(x)));
+    for (auto& e : results) blocking_get(std::move(e));
+
+    // A future is ready before its task is counted as completed.
+    while (limited.statistics()._running || other.statistics()._running) {
+        this_thread::yield();
+    }
+
+    BOOST_REQUIRE_LE(peak.load(), 2);
+    BOOST_REQUIRE_EQUAL(16u, limited.statistics()._completed);
+    BOOST_REQUIRE_EQUAL(1u, other.statistics()._completed);
+}
+
+BOOST_AUTO_TEST_CASE(group_scheduler_releases_the_slot_of_a_throwing_task) {
+    BOOST_TEST_MESSAGE("running group_scheduler releases the slot of a throwing task");
+
+    manual_executor pool;
+    group_scheduler scheduler{pool};
+    auto limited = scheduler.make_group_executor(1, 1);
+
+    bool ran = false;
+    limited([&] {
+        // The run for this task finds the only slot taken and is deferred.
+        limited([&] { ran = true; });
+        pool.run_one();
+        throw 0;
+    });
+
+    BOOST_REQUIRE_THROW(pool.run_one(), int);
+    while (pool.run_one()) {}
+    BOOST_REQUIRE(ran);
+
+    auto s = limited.statistics();
+    BOOST_REQUIRE_EQUAL(0u, s._running);
+    BOOST_REQUIRE_EQUAL(2u, s._completed);
+}
@@ -0,0 +1,164 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+/**************************************************************************************************/
+
+#include <boost/test/unit_test.hpp>
+
+#include <stlab/concurrency/io_reactor.hpp>
+
+#if STLAB_FEATURE(EPOLL)
+
+#include <stlab/concurrency/utility.hpp>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace stlab;
+using namespace std;
+
+namespace {
+
+struct pipe_fixture {
+    int _fd[2];
+    pipe_fixture() { BOOST_REQUIRE_EQUAL(0, ::pipe(_fd)); }
+    ~pipe_fixture() {
+        ::close(_fd[0]);
+        ::close(_fd[1]);
+    }
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(io_reactor_completes_a_read_when_data_arrives, pipe_fixture) {
+    BOOST_TEST_MESSAGE("A read on an empty pipe completes once data is written");
+
+    io_reactor reactor;
+    char buffer[16]{};
+
+    auto read = reactor.read(_fd[0], buffer, sizeof(buffer));
+    BOOST_REQUIRE(!read.is_ready());
+
+    BOOST_REQUIRE_EQUAL(5u, blocking_get(reactor.write(_fd[1], "hello", 5)));
+    BOOST_REQUIRE_EQUAL(5u, blocking_get(read));
+    BOOST_REQUIRE_EQUAL(string("hello"), string(buffer));
+}
+
+BOOST_FIXTURE_TEST_CASE(io_reactor_reads_complete_in_submission_order, pipe_fixture) {
+    BOOST_TEST_MESSAGE("Reads on the same descriptor complete in the order they were submitted");
+
+    io_reactor reactor;
+    char first[2]{};
+    char second[2]{};
+
+    auto a = reactor.read(_fd[0], first, 1);
+    auto b = reactor.read(_fd[0], second, 1);
+
+    BOOST_REQUIRE_EQUAL(2u, blocking_get(reactor.write(_fd[1], "ab", 2)));
+    BOOST_REQUIRE_EQUAL(1u, blocking_get(a));
+    BOOST_REQUIRE_EQUAL(1u, blocking_get(b));
+    BOOST_REQUIRE_EQUAL('a', first[0]);
+    BOOST_REQUIRE_EQUAL('b', second[0]);
+}
+
+BOOST_AUTO_TEST_CASE(io_reactor_completes_a_write_when_the_socket_drains) {
+    BOOST_TEST_MESSAGE("A write on a full socket completes once the peer reads");
+
+    int fd[2];
+    BOOST_REQUIRE_EQUAL(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fd));
+
+    io_reactor reactor;
+    vector<char> data(1 << 20, 'x');
+
+    // Fill the socket buffer until a write has to wait.
+    future<size_t> pending;
+    do {
+        pending = reactor.write(fd[0], data.data(), data.size());
+    } while (pending.is_ready());
+
+    vector<char> buffer(1 << 16);
+    while (!pending.is_ready()) BOOST_REQUIRE_LT(0, ::read(fd[1], buffer.data(), buffer.size()));
+    BOOST_REQUIRE_LT(0u, blocking_get(pending));
+
+    ::close(fd[0]);
+    ::close(fd[1]);
+}
+
+BOOST_AUTO_TEST_CASE(io_reactor_reads_and_writes_regular_files) {
+    BOOST_TEST_MESSAGE("Operations on regular files complete immediately");
+
+    char name[] = "/tmp/stlab_io_reactor_XXXXXX";
+    int fd = ::mkstemp(name);
+    BOOST_REQUIRE_LE(0, fd);
+    ::unlink(name);
+
+    io_reactor reactor;
+    BOOST_REQUIRE_EQUAL(6u, blocking_get(reactor.write(fd, "stlab!", 6)));
+    BOOST_REQUIRE_EQUAL(0, ::lseek(fd, 0, SEEK_SET));
+
+    char buffer[8]{};
+    BOOST_REQUIRE_EQUAL(6u, blocking_get(reactor.read(fd, buffer, sizeof(buffer))));
+    BOOST_REQUIRE_EQUAL(string("stlab!"), string(buffer));
+    BOOST_REQUIRE_EQUAL(0u, blocking_get(reactor.read(fd, buffer, sizeof(buffer))));
+
+    ::close(fd);
+}
+
+BOOST_AUTO_TEST_CASE(io_reactor_accepts_connections) {
+    BOOST_TEST_MESSAGE("accept() completes when a client connects");
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    BOOST_REQUIRE_LE(0, listener);
+
+    // An abstract socket name, it does not appear in the file system.
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    auto name = "stlab_io_reactor_" + to_string(::getpid());
+    memcpy(address.sun_path + 1, name.data(), name.size());
+    auto size = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + name.size());
+
+    BOOST_REQUIRE_EQUAL(0, ::bind(listener, reinterpret_cast<sockaddr*>(&address), size));
+    BOOST_REQUIRE_EQUAL(0, ::listen(listener, 1));
+
+    io_reactor reactor;
+    auto accepted = reactor.accept(listener);
+    BOOST_REQUIRE(!accepted.is_ready());
+
+    int client = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    BOOST_REQUIRE_EQUAL(0, ::connect(client, reinterpret_cast<sockaddr*>(&address), size));
+
+    int server = blocking_get(accepted);
+    BOOST_REQUIRE_LE(0, server);
+
+    char buffer[4]{};
+    auto read = reactor.read(server, buffer, 3);
+    BOOST_REQUIRE_EQUAL(3, ::write(client, "abc", 3));
+    BOOST_REQUIRE_EQUAL(3u, blocking_get(read));
+
+    ::close(server);
+    ::close(client);
+    ::close(listener);
+}
+
+BOOST_FIXTURE_TEST_CASE(io_reactor_breaks_pending_promises_on_destruction, pipe_fixture) {
+    BOOST_TEST_MESSAGE("Pending operations fail with broken_promise when the reactor is destroyed");
+
+    char buffer[4];
+    future<size_t> read;
+    {
+        io_reactor reactor;
+        read = reactor.read(_fd[0], buffer, sizeof(buffer));
+    }
+    BOOST_REQUIRE_THROW(blocking_get(read), future_error);
+}
+
+#endif
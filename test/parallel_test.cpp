@@ -0,0 +1,191 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+/**************************************************************************************************/
+
+#include <boost/test/unit_test.hpp>
+
+#include <stlab/algorithm/parallel.hpp>
+#include <stlab/concurrency/default_executor.hpp>
+#include <stlab/concurrency/utility.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace stlab;
+using namespace std;
+
+namespace {
+
+vector<int> random_ints(size_t n) {
+    vector<int> result(n);
+    mt19937 generator{42};
+    uniform_int_distribution<int> distribution{-1000, 1000};
+    for (auto& e : result) e = distribution(generator);
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(parallel_for_visits_each_element_once) {
+    BOOST_TEST_MESSAGE("running parallel_for visits each element once");
+
+    for (size_t n : {0, 1, 7, 1000, 100'000}) {
+        vector<atomic_int> visits(n);
+        blocking_get(parallel_for(default_executor, begin(visits), end(visits),
+                                  [](atomic_int& x) { ++x; }));
+        BOOST_REQUIRE(all_of(begin(visits), end(visits), [](const auto& x) { return x == 1; }));
+
+        vector<atomic_int> indices(n);
+        blocking_parallel_for(default_executor, size_t{0}, n, [&](size_t i) { ++indices[i]; });
+        BOOST_REQUIRE(all_of(begin(indices), end(indices), [](const auto& x) { return x == 1; }));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_transform_matches_transform) {
+    BOOST_TEST_MESSAGE("running parallel_transform matches transform");
+
+    auto input = random_ints(50'000);
+    vector<string> expected(input.size());
+    transform(begin(input), end(input), begin(expected), [](int x) { return to_string(x); });
+
+    vector<string> result(input.size());
+    auto last = blocking_get(parallel_transform(default_executor, begin(input), end(input),
+                                                begin(result), [](int x) { return to_string(x); }));
+    BOOST_REQUIRE(last == end(result));
+    BOOST_REQUIRE(result == expected);
+
+    vector<string> blocking(input.size());
+    blocking_parallel_transform(default_executor, begin(input), end(input), begin(blocking),
+                                [](int x) { return to_string(x); });
+    BOOST_REQUIRE(blocking == expected);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_reduce_combines_in_order) {
+    BOOST_TEST_MESSAGE("running parallel_reduce combines in order");
+
+    auto input = random_ints(100'000);
+    auto expected = accumulate(begin(input), end(input), int64_t{5});
+
+    BOOST_REQUIRE_EQUAL(expected, blocking_get(parallel_reduce(default_executor, begin(input),
+                                                               end(input), int64_t{5})));
+    BOOST_REQUIRE_EQUAL(expected,
+                        blocking_parallel_reduce(default_executor, begin(input), end(input),
+                                                 int64_t{5}));
+
+    // String concatenation is associative but not commutative.
+    vector<string> letters;
+    for (char c = 'a'; c <= 'z'; ++c) letters.emplace_back(1, c);
+    for (int n = 0; n != 10; ++n) letters.insert(end(letters), begin(letters), end(letters));
+    auto joined = accumulate(begin(letters), end(letters), string{">"});
+    BOOST_REQUIRE_EQUAL(joined, blocking_parallel_reduce(default_executor, begin(letters),
+                                                         end(letters), string{">"}));
+
+    BOOST_REQUIRE_EQUAL(3, blocking_parallel_reduce(default_executor, begin(input),
+                                                    begin(input), 3));
+}
+
+BOOST_AUTO_TEST_CASE(parallel_scan_matches_partial_sum) {
+    BOOST_TEST_MESSAGE("running parallel_scan matches partial_sum");
+
+    for (size_t n : {0, 1, 5, 1000, 100'003}) {
+        auto input = random_ints(n);
+        vector<int64_t> expected(n);
+        int64_t sum = 7;
+        for (size_t k = 0; k != n; ++k) expected[k] = sum += input[k];
+
+        vector<int64_t> result(n);
+        blocking_get(parallel_scan(default_executor, begin(input), end(input), begin(result),
+                                   int64_t{7}));
+        BOOST_REQUIRE(result == expected);
+
+        // in place
+        vector<int64_t> values(begin(input), end(input));
+        blocking_parallel_scan(default_executor, begin(values), end(values), begin(values),
+                               int64_t{7});
+        BOOST_REQUIRE(values == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_sort_sorts) {
+    BOOST_TEST_MESSAGE("running parallel_sort sorts");
+
+    for (size_t n : {0, 1, 100, 5000, 300'000}) {
+        auto input = random_ints(n);
+        auto expected = input;
+        sort(begin(expected), end(expected), greater<>());
+
+        auto result = input;
+        blocking_get(parallel_sort(default_executor, begin(result), end(result), greater<>()));
+        BOOST_REQUIRE(result == expected);
+
+        result = input;
+        blocking_parallel_sort(default_executor, begin(result), end(result), greater<>());
+        BOOST_REQUIRE(result == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_algorithms_report_exceptions) {
+    BOOST_TEST_MESSAGE("running parallel algorithms report exceptions");
+
+    vector<int> input(100'000, 1);
+    input[70'000] = 0;
+    auto check = [](int x) {
+        if (x == 0) throw runtime_error("zero");
+    };
+
+    BOOST_REQUIRE_THROW(blocking_get(parallel_for(default_executor, begin(input), end(input),
+                                                  check)),
+                        runtime_error);
+    BOOST_REQUIRE_THROW(blocking_parallel_for(default_executor, begin(input), end(input), check),
+                        runtime_error);
+    BOOST_REQUIRE_THROW(blocking_parallel_reduce(default_executor, begin(input), end(input), 0,
+                                                 [](int x, int y) {
+                                                     if (y == 0) throw runtime_error("zero");
+                                                     return x + y;
+                                                 }),
+                        runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(measure_parallel_algorithms) {
+    BOOST_TEST_MESSAGE("Measure the parallel algorithms against their sequential counterparts");
+
+    auto input = random_ints(4'000'000);
+    auto measure = [](auto f) {
+        auto start = chrono::steady_clock::now();
+        f();
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+
+    auto values = input;
+    auto sequential_sort = measure([&] { sort(begin(values), end(values)); });
+    values = input;
+    auto parallel_sort = measure(
+        [&] { blocking_parallel_sort(default_executor, begin(values), end(values)); });
+    BOOST_REQUIRE(is_sorted(begin(values), end(values)));
+
+    vector<double> out(input.size());
+    auto f = [](int x) { return sqrt(static_cast<double>(x * x + 1)); };
+    auto sequential_transform =
+        measure([&] { transform(begin(input), end(input), begin(out), f); });
+    auto parallel_transform = measure([&] {
+        blocking_parallel_transform(default_executor, begin(input), end(input), begin(out), f);
+    });
+
+    cout << "\nsort of 4M ints, sequential:      " << sequential_sort << "ms\n";
+    cout << "sort of 4M ints, parallel:        " << parallel_sort << "ms\n";
+    cout << "transform of 4M ints, sequential: " << sequential_transform << "ms\n";
+    cout << "transform of 4M ints, parallel:   " << parallel_transform << "ms\n";
+}
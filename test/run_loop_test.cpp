@@ -0,0 +1,122 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+/**************************************************************************************************/
+
+#include <boost/test/unit_test.hpp>
+
+#include <stlab/concurrency/default_executor.hpp>
+#include <stlab/concurrency/future.hpp>
+#include <stlab/concurrency/main_executor.hpp>
+#include <stlab/concurrency/run_loop.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace stlab;
+using namespace std;
+
+BOOST_AUTO_TEST_CASE(run_loop_poll_runs_posted_tasks_in_order) {
+    BOOST_TEST_MESSAGE("poll() runs the posted tasks in the order they were posted");
+
+    run_loop loop;
+    vector<int> result;
+
+    BOOST_REQUIRE_EQUAL(0u, loop.poll());
+
+    for (int n = 0; n != 3; ++n) loop.executor()([&result, n] { result.push_back(n); });
+
+    BOOST_REQUIRE_EQUAL(3u, loop.poll());
+    BOOST_REQUIRE((result == vector<int>{0, 1, 2}));
+    BOOST_REQUIRE_EQUAL(0u, loop.poll());
+}
+
+BOOST_AUTO_TEST_CASE(run_loop_poll_runs_tasks_posted_while_draining_on_the_next_call) {
+    BOOST_TEST_MESSAGE("poll() leaves the tasks posted by a running task for the next call");
+
+    run_loop loop;
+    vector<int> result;
+
+    loop.post([&] {
+        result.push_back(0);
+        loop.post([&] { result.push_back(2); });
+    });
+    loop.post([&] { result.push_back(1); });
+
+    BOOST_REQUIRE_EQUAL(2u, loop.poll());
+    BOOST_REQUIRE((result == vector<int>{0, 1}));
+    BOOST_REQUIRE_EQUAL(1u, loop.poll());
+    BOOST_REQUIRE((result == vector<int>{0, 1, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(run_loop_runs_tasks_posted_from_many_threads_on_its_thread) {
+    BOOST_TEST_MESSAGE("Tasks posted from many threads run on the thread running the loop");
+
+    const int producers = 4;
+    const int count = 10'000;
+
+    run_loop loop;
+    int executed = 0; // only touched by the loop thread
+    bool other_thread = false;
+    auto id = this_thread::get_id();
+
+    vector<thread> threads;
+    for (int p = 0; p != producers; ++p) {
+        threads.emplace_back([&] {
+            for (int n = 0; n != count; ++n) {
+                loop.executor()([&] {
+                    other_thread = other_thread || this_thread::get_id() != id;
+                    if (++executed == producers * count) loop.stop();
+                });
+            }
+        });
+    }
+
+    loop.run();
+    for (auto& e : threads) e.join();
+
+    BOOST_REQUIRE_EQUAL(producers * count, executed);
+    BOOST_REQUIRE(!other_thread);
+}
+
+BOOST_AUTO_TEST_CASE(run_loop_run_until_returns_the_result_of_a_future) {
+    BOOST_TEST_MESSAGE("run_until() runs continuations on the loop until the future is ready");
+
+    run_loop loop;
+    auto id = this_thread::get_id();
+
+    auto result = async(default_executor, [] { return 20; })
+                      .then(loop.executor(), [&](int x) {
+                          BOOST_REQUIRE(this_thread::get_id() == id);
+                          return x * 2;
+                      })
+                      .then(default_executor, [](int x) { return x + 2; });
+
+    BOOST_REQUIRE_EQUAL(42, loop.run_until(move(result)));
+}
+
+BOOST_AUTO_TEST_CASE(run_loop_run_until_rethrows_the_exception_of_a_future) {
+    BOOST_TEST_MESSAGE("run_until() rethrows the exception of the future");
+
+    run_loop loop;
+    auto result = async(loop.executor(), []() -> int { throw std::runtime_error("failure"); });
+
+    BOOST_REQUIRE_THROW(loop.run_until(move(result)), std::runtime_error);
+}
+
+#if STLAB_MAIN_EXECUTOR == STLAB_MAIN_EXECUTOR_PORTABLE && !__APPLE__
+
+BOOST_AUTO_TEST_CASE(main_executor_posts_to_the_main_loop) {
+    BOOST_TEST_MESSAGE("main_executor posts its tasks to main_loop()");
+
+    auto id = this_thread::get_id();
+    auto result = async(default_executor, [] { return 42; }).then(main_executor, [&](int x) {
+        return this_thread::get_id() == id ? x : 0;
+    });
+
+    BOOST_REQUIRE_EQUAL(42, main_loop().run_until(move(result)));
+}
+
+#endif
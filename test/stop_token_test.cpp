@@ -0,0 +1,206 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+/**************************************************************************************************/
+
+#include <boost/test/unit_test.hpp>
+
+#include <stlab/concurrency/channel.hpp>
+#include <stlab/concurrency/default_executor.hpp>
+#include <stlab/concurrency/future.hpp>
+#include <stlab/concurrency/immediate_executor.hpp>
+#include <stlab/concurrency/stop_token.hpp>
+#include <stlab/concurrency/utility.hpp>
+
+#include <atomic>
+#include <vector>
+
+using namespace stlab;
+using namespace std;
+
+namespace {
+
+bool is_canceled(const future_error& error) {
+    return error.code() == future_error_codes::canceled;
+}
+
+// Yields the running sum of the values it awaits, and once more when it is closed.
+struct summing_process {
+    int _sum{0};
+    process_state_scheduled _state{await_forever};
+
+    void await(int x) { _sum += x; }
+
+    int yield() {
+        _state = await_forever;
+        return _sum;
+    }
+
+    void close() { _state = yield_immediate; }
+
+    auto state() const { return _state; }
+};
+
+// Records the values it awaits and whether it was sent a cancellation error.
+struct recorder {
+    vector<int>* _received;
+    bool* _canceled;
+
+    void await(int x) { _received->push_back(x); }
+
+    int yield() { return 0; }
+
+    auto state() const { return await_forever; }
+
+    void set_error(std::exception_ptr error) {
+        try {
+            std::rethrow_exception(error);
+        } catch (const future_error& e) {
+            *_canceled = is_canceled(e);
+        }
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(stop_source_is_observed_by_its_tokens) {
+    BOOST_TEST_MESSAGE("running stop_source is observed by its tokens");
+
+    stop_token unassociated;
+    BOOST_REQUIRE(!unassociated.stop_possible());
+    BOOST_REQUIRE(!unassociated.stop_requested());
+
+    stop_source source;
+    auto token = source.get_token();
+    BOOST_REQUIRE(token.stop_possible());
+    BOOST_REQUIRE(token == source.get_token());
+    BOOST_REQUIRE(!token.stop_requested());
+
+    BOOST_REQUIRE(source.request_stop());
+    BOOST_REQUIRE(!source.request_stop());
+    BOOST_REQUIRE(token.stop_requested());
+    BOOST_REQUIRE(source.stop_requested());
+}
+
+BOOST_AUTO_TEST_CASE(stopped_continuations_are_skipped) {
+    BOOST_TEST_MESSAGE("running stopped continuations are skipped");
+
+    stop_source source;
+    auto token = source.get_token();
+    int calls = 0;
+
+    auto p = package<int()>(immediate_executor, [] { return 1; });
+    auto result = p.second
+                      .then(with_stop(token,
+                                      [&](int x) {
+                                          ++calls;
+                                          return x + 1;
+                                      }))
+                      .then([&](int x) {
+                          ++calls;
+                          return x;
+                      });
+
+    source.request_stop();
+    p.first();
+
+    BOOST_REQUIRE_EXCEPTION(result.get_try(), future_error, is_canceled);
+    BOOST_REQUIRE_EQUAL(0, calls);
+}
+
+BOOST_AUTO_TEST_CASE(stop_with_async_recover_and_when_all) {
+    BOOST_TEST_MESSAGE("running stop with async, recover and when_all");
+
+    stop_source source;
+    auto token = source.get_token();
+    source.request_stop();
+
+    auto a = async(immediate_executor, with_stop(token, [] { return 1; }));
+    BOOST_REQUIRE_EXCEPTION(a.get_try(), future_error, is_canceled);
+
+    auto r = make_ready_future(2, immediate_executor)
+                 .recover(with_stop(token, [](future<int> x) { return *x.get_try(); }));
+    BOOST_REQUIRE_EXCEPTION(r.get_try(), future_error, is_canceled);
+
+    auto w = when_all(immediate_executor, with_stop(token, [](int x, int y) { return x + y; }),
+                      make_ready_future(1, immediate_executor),
+                      make_ready_future(2, immediate_executor));
+    BOOST_REQUIRE_EXCEPTION(w.get_try(), future_error, is_canceled);
+
+    // Without a stop the wrapped function is invoked.
+    stop_source running;
+    auto b = async(immediate_executor, with_stop(running.get_token(), [] { return 3; }));
+    BOOST_REQUIRE_EQUAL(3, *b.get_try());
+}
+
+BOOST_AUTO_TEST_CASE(running_work_observes_the_token) {
+    BOOST_TEST_MESSAGE("running work observes the token");
+
+    stop_source source;
+    atomic_bool started{false};
+
+    auto result = async(default_executor, [&started, token = source.get_token()] {
+        started = true;
+        int iterations = 0;
+        while (!token.stop_requested()) ++iterations;
+        return iterations >= 0;
+    });
+
+    while (!started) this_thread::yield();
+    source.request_stop();
+    BOOST_REQUIRE(blocking_get(std::move(result)));
+}
+
+BOOST_AUTO_TEST_CASE(stopped_channel_process_is_skipped) {
+    BOOST_TEST_MESSAGE("running stopped channel process is skipped");
+
+    stop_source source;
+    vector<int> received;
+
+    auto p = channel<int>(immediate_executor);
+    auto hold = p.second | with_stop(source.get_token(), [](int x) { return 2 * x; }) |
+                [&](int x) { received.push_back(x); };
+    p.second.set_ready();
+
+    p.first(1);
+    source.request_stop();
+    p.first(2);
+
+    BOOST_REQUIRE((received == vector<int>{2}));
+}
+
+BOOST_AUTO_TEST_CASE(stopped_channel_process_with_await_and_yield_is_skipped) {
+    BOOST_TEST_MESSAGE("running stopped channel process with await and yield is skipped");
+
+    auto run = [](auto process, stop_source& source) {
+        vector<int> received;
+        bool canceled = false;
+
+        auto p = channel<int>(immediate_executor);
+        auto hold = p.second | std::move(process) | recorder{&received, &canceled};
+        hold.set_ready();
+        p.second.set_ready();
+
+        p.first(1);
+        p.first(2);
+        source.request_stop();
+        p.first(3);
+        p.first.close();
+
+        return make_pair(received, canceled);
+    };
+
+    stop_source unused;
+    auto expected = run(summing_process{}, unused);
+
+    // Until the stop the wrapper forwards await(), yield(), state(), and close().
+    stop_source source;
+    auto stopped = run(with_stop(source.get_token(), summing_process{}), source);
+
+    BOOST_REQUIRE(!expected.second);
+    BOOST_REQUIRE_LT(stopped.first.size(), expected.first.size());
+    BOOST_REQUIRE(equal(begin(stopped.first), end(stopped.first), begin(expected.first)));
+    BOOST_REQUIRE(stopped.second);
+}
@@ -0,0 +1,193 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+/**************************************************************************************************/
+
+#include <boost/test/unit_test.hpp>
+
+#include <stlab/concurrency/default_executor.hpp>
+#include <stlab/concurrency/future.hpp>
+#include <stlab/concurrency/task_group.hpp>
+#include <stlab/concurrency/utility.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace stlab;
+using namespace std;
+
+namespace {
+
+template <class I>
+void quicksort(I first, I last) {
+    if (last - first < 512) return sort(first, last);
+
+    auto pivot = *(first + (last - first) / 2);
+    auto middle1 = partition(first, last, [&](const auto& x) { return x < pivot; });
+    auto middle2 = partition(middle1, last, [&](const auto& x) { return !(pivot < x); });
+
+    task_group group{default_executor};
+    group.run([=] { quicksort(first, middle1); });
+    quicksort(middle2, last);
+    group.wait();
+}
+
+int fibonacci_group(int n) {
+    if (n < 2) return n;
+    int x;
+    task_group group{default_executor};
+    group.run([&] { x = fibonacci_group(n - 1); });
+    int y = fibonacci_group(n - 2);
+    group.wait();
+    return x + y;
+}
+
+int fibonacci_futures(int n) {
+    if (n < 2) return n;
+    auto x = async(default_executor, [n] { return fibonacci_futures(n - 1); });
+    int y = fibonacci_futures(n - 2);
+    return blocking_get(std::move(x)) + y;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(task_group_runs_recursive_quicksort) {
+    BOOST_TEST_MESSAGE("running task_group runs recursive quicksort");
+
+    vector<int> values(200'000);
+    mt19937 generator{7};
+    for (auto& e : values) e = static_cast<int>(generator() % 10'000);
+
+    quicksort(begin(values), end(values));
+    BOOST_REQUIRE(is_sorted(begin(values), end(values)));
+}
+
+BOOST_AUTO_TEST_CASE(task_group_rethrows_the_first_exception) {
+    BOOST_TEST_MESSAGE("running task_group rethrows the first exception");
+
+    atomic_int count{0};
+    task_group group{default_executor};
+    for (int n = 0; n != 10; ++n) {
+        group.run([&, n] {
+            ++count;
+            if (n == 3) throw runtime_error("failed");
+        });
+    }
+    BOOST_REQUIRE_THROW(group.wait(), runtime_error);
+    BOOST_REQUIRE_EQUAL(10, count.load());
+
+    // The group can be reused and the error is reported once.
+    group.run([&] { ++count; });
+    group.wait();
+    BOOST_REQUIRE_EQUAL(11, count.load());
+}
+
+BOOST_AUTO_TEST_CASE(task_group_limits_outstanding_children) {
+    BOOST_TEST_MESSAGE("running task_group limits outstanding children");
+
+    atomic_int outstanding{0};
+    atomic_int peak{0};
+    atomic_int inline_count{0};
+    const auto caller = this_thread::get_id();
+
+    {
+        task_group group{default_executor, 4};
+        for (int n = 0; n != 100; ++n) {
+            auto current = ++outstanding;
+            auto p = peak.load();
+            while (p < current && !peak.compare_exchange_weak(p, current)) {}
+            group.run([&] {
+                if (this_thread::get_id() == caller) ++inline_count;
+                this_thread::sleep_for(chrono::microseconds(100));
+                --outstanding;
+            });
+        }
+    }
+
+    BOOST_REQUIRE_EQUAL(0, outstanding.load());
+    BOOST_REQUIRE_LE(peak.load(), 5); // the four outstanding and the one being submitted
+    BOOST_REQUIRE_GT(inline_count.load(), 0);
+}
+
+#if STLAB_TASK_SYSTEM(PORTABLE)
+
+BOOST_AUTO_TEST_CASE(task_group_wait_keeps_the_task_system_running) {
+    BOOST_TEST_MESSAGE("running task_group wait blocks under a blocking_guard");
+
+    const unsigned count = 2;
+    stlab::priority_task_system system{task_system_options{count, "task_group"}};
+
+    // Runs each child on a thread of its own, so wait() finds none left to take.
+    mutex threads_mutex;
+    vector<thread> threads;
+    auto on_thread = [&](task<void()> f) {
+        unique_lock<mutex> lock{threads_mutex};
+        threads.emplace_back(std::move(f));
+    };
+
+    mutex m;
+    condition_variable ready;
+    unsigned started = 0;
+    bool released = false;
+    atomic_int finished{0};
+
+    for (unsigned n = 0; n != count; ++n) {
+        system.executor()([&] {
+            task_group group{on_thread};
+            group.run([&] {
+                unique_lock<mutex> lock{m};
+                ++started;
+                ready.notify_all();
+                ready.wait(lock, [&] { return released; });
+            });
+            {
+                unique_lock<mutex> lock{m};
+                ready.wait(lock, [&] { return started == count; });
+            }
+            group.wait();
+            ++finished;
+        });
+    }
+
+    {
+        unique_lock<mutex> lock{m};
+        ready.wait(lock, [&] { return started == count; });
+    }
+
+    // Every worker waits on its group, so this task only runs on a compensating thread.
+    system.executor()([&] {
+        {
+            unique_lock<mutex> lock{m};
+            released = true;
+        }
+        ready.notify_all();
+    });
+
+    while (finished != count) this_thread::yield();
+    for (auto& e : threads) e.join();
+}
+
+#endif
+
+BOOST_AUTO_TEST_CASE(measure_task_group_against_blocking_get) {
+    BOOST_TEST_MESSAGE("Measure recursive fork-join with task_group against blocking_get");
+
+    auto measure = [](auto f) {
+        auto start = chrono::steady_clock::now();
+        BOOST_REQUIRE_EQUAL(610, f(15));
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+
+    cout << "\nfibonacci(15), task_group:   " << measure(fibonacci_group) << "ms\n";
+    cout << "fibonacci(15), blocking_get: " << measure(fibonacci_futures) << "ms\n";
+}
@@ -6,15 +6,22 @@
 /**************************************************************************************************/
 
 // stdc++
+#include <array>
 #include <iostream>
 
 // boost
 #include <boost/test/unit_test.hpp>
 
 // stlab
+#include <stlab/concurrency/config.hpp>
+#include <stlab/concurrency/function_ref.hpp>
 #include <stlab/concurrency/task.hpp>
 #include <stlab/test/model.hpp>
 
+#if STLAB_CPP_VERSION_AT_LEAST(17) && __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
 /**************************************************************************************************/
 
 using namespace stlab;
@@ -356,3 +363,219 @@ BOOST_AUTO_TEST_CASE(task_equality_tests) {
         BOOST_CHECK(std::nullptr_t() != a);
     }
 }
+
+BOOST_AUTO_TEST_CASE(task_inline_size_tests) {
+    struct large {
+        char _data[96]{};
+        int operator()() { return 42; }
+    };
+
+    static_assert(task_fits_inline<void (*)()>::value, "");
+    static_assert(!task_fits_inline<large>::value, "");
+    static_assert(task_fits_inline<large, 128>::value, "");
+    static_assert(sizeof(task<int(), 128>) > sizeof(task<int()>), "");
+
+    auto is_inline = [](auto& t) {
+        auto p = reinterpret_cast<const char*>(t.template target<large>());
+        auto first = reinterpret_cast<const char*>(&t);
+        return first <= p && p < first + sizeof(t);
+    };
+
+    {
+        task<int()> t{large{}};
+        BOOST_CHECK(!is_inline(t));
+        BOOST_CHECK_EQUAL(t(), 42);
+    }
+    {
+        task<int(), 128> t{large{}};
+        BOOST_CHECK(is_inline(t));
+        task<int(), 128> u{std::move(t)};
+        BOOST_CHECK(is_inline(u));
+        BOOST_CHECK_EQUAL(u(), 42);
+    }
+}
+
+namespace {
+
+template <class T>
+struct counting_allocator {
+    using value_type = T;
+
+    int* _count;
+
+    explicit counting_allocator(int* count) : _count(count) {}
+    template <class U>
+    counting_allocator(const counting_allocator<U>& x) : _count(x._count) {}
+
+    T* allocate(std::size_t n) {
+        ++*_count;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, std::size_t n) {
+        --*_count;
+        std::allocator<T>().deallocate(p, n);
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(task_allocator_tests) {
+    struct large {
+        char _data[96]{};
+        int operator()() { return 42; }
+    };
+
+    int count = 0;
+    counting_allocator<char> alloc{&count};
+
+    {
+        task<int()> t{std::allocator_arg, alloc, large{}};
+        BOOST_CHECK_EQUAL(count, 1);
+        task<int()> u{std::move(t)};
+        BOOST_CHECK_EQUAL(count, 1);
+        BOOST_CHECK_EQUAL(u(), 42);
+    }
+    BOOST_CHECK_EQUAL(count, 0);
+
+    {
+        // Small callables are stored inline and do not use the allocator.
+        task<int()> t{std::allocator_arg, alloc, [] { return 7; }};
+        BOOST_CHECK_EQUAL(count, 0);
+        BOOST_CHECK_EQUAL(t(), 7);
+    }
+
+    {
+        task<int()> t{std::allocator_arg, alloc, static_cast<int (*)()>(nullptr)};
+        BOOST_CHECK(!t);
+    }
+}
+
+#if STLAB_CPP_VERSION_AT_LEAST(17) && __has_include(<memory_resource>)
+
+BOOST_AUTO_TEST_CASE(task_memory_resource_tests) {
+    std::array<std::byte, 1024> buffer;
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(),
+                                              std::pmr::null_memory_resource()};
+    std::pmr::polymorphic_allocator<std::byte> alloc{&arena};
+
+    std::array<char, 128> data{};
+    data[0] = 42;
+    auto f = [data] { return int{data[0]}; };
+    task<int()> t{std::allocator_arg, alloc, f};
+    BOOST_CHECK_EQUAL(t(), 42);
+
+    auto p = reinterpret_cast<const std::byte*>(t.target<decltype(f)>());
+    BOOST_CHECK(buffer.data() <= p && p < buffer.data() + buffer.size());
+}
+
+#endif
+
+namespace {
+
+struct counted_move {
+    int* _moves;
+
+    explicit counted_move(int* moves) : _moves(moves) {}
+    counted_move(const counted_move& x) : _moves(x._moves) { ++*_moves; }
+
+    void operator()() {}
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(task_relocation_tests) {
+    static_assert(is_trivially_relocatable<void (*)()>::value, "");
+    static_assert(is_trivially_relocatable<std::unique_ptr<int>>::value, "");
+    static_assert(!is_trivially_relocatable<counted_move>::value, "");
+
+    {
+        int x = 0;
+        task<void()> t{[&x] { ++x; }};
+        task<void()> u{std::move(t)};
+        BOOST_CHECK(!t); // a relocated task is left empty
+        u();
+        BOOST_CHECK_EQUAL(x, 1);
+
+        t = std::move(u);
+        BOOST_CHECK(!u);
+        t();
+        BOOST_CHECK_EQUAL(x, 2);
+    }
+
+    {
+        int moves = 0;
+        task<void()> t{counted_move{&moves}};
+        moves = 0;
+        task<void()> u{std::move(t)};
+        BOOST_CHECK_EQUAL(moves, 1);
+        u();
+    }
+
+    {
+        struct large {
+            char _data[96]{};
+            int operator()() { return 42; }
+        };
+        task<int()> t{large{}};
+        task<int()> u{std::move(t)};
+        BOOST_CHECK(!t);
+        BOOST_CHECK_EQUAL(u(), 42);
+    }
+}
+
+namespace {
+
+int twice(int x) { return 2 * x; }
+
+int apply(function_ref<int(int)> f, int x) { return f(x); }
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(function_ref_tests) {
+    static_assert(std::is_convertible<int (*)(int), function_ref<int(int)>>::value, "");
+    static_assert(!std::is_convertible<int (*)(), function_ref<int(int)>>::value, "");
+    static_assert(std::is_trivially_copyable<function_ref<int(int)>>::value, "");
+
+    BOOST_CHECK_EQUAL(apply(twice, 21), 42);
+    BOOST_CHECK_EQUAL(apply(&twice, 21), 42);
+    BOOST_CHECK_EQUAL(apply([](int x) { return x + 1; }, 41), 42);
+
+    // The referenced object is called, not a copy of it.
+    int calls = 0;
+    auto counter = [&calls](int x) mutable {
+        ++calls;
+        return x;
+    };
+    function_ref<int(int)> f{counter};
+    function_ref<int(int)> g{f};
+    f(1);
+    g(2);
+    BOOST_CHECK_EQUAL(calls, 2);
+
+    const auto constant = [](int) { return 7; };
+    BOOST_CHECK_EQUAL(apply(constant, 0), 7);
+
+    // Results convert to the signature, and any result can be discarded.
+    function_ref<long(int)> widening{counter};
+    BOOST_CHECK_EQUAL(widening(5), 5L);
+    function_ref<void(int)> discarding{counter};
+    discarding(0);
+    BOOST_CHECK_EQUAL(calls, 4);
+
+    move_only m{42};
+    auto by_reference = [](move_only& x) { return x.member(); };
+    BOOST_CHECK_EQUAL(function_ref<int(move_only&)>{by_reference}(m), 42);
+}
+
+BOOST_AUTO_TEST_CASE(function_ref_holds_function_pointers_by_value) {
+    // The temporary pointers are gone before the calls, the function_refs hold their values.
+    function_ref<int(int)> from_pointer{&twice};
+    function_ref<int(int)> from_function{twice};
+    int (*pointer)(int) = twice;
+    function_ref<int(int)> from_variable{pointer};
+    pointer = nullptr;
+
+    BOOST_CHECK_EQUAL(from_pointer(21), 42);
+    BOOST_CHECK_EQUAL(from_function(21), 42);
+    BOOST_CHECK_EQUAL(from_variable(21), 42);
+}
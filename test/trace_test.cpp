@@ -0,0 +1,125 @@
+/*
+    Copyright 2026 Adobe
+    Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+*/
+/**************************************************************************************************/
+
+#define STLAB_ENABLE_TASK_SYSTEM_TRACE
+
+#include <boost/test/unit_test.hpp>
+
+#include <stlab/concurrency/channel.hpp>
+#include <stlab/concurrency/default_executor.hpp>
+#include <stlab/concurrency/future.hpp>
+#include <stlab/concurrency/trace.hpp>
+#include <stlab/concurrency/utility.hpp>
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace stlab;
+using namespace std;
+
+#if STLAB_TASK_SYSTEM(PORTABLE)
+
+namespace {
+
+void rest() { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+struct traced_work {
+    int operator()() const { return 42; }
+};
+
+struct traced_continuation {
+    int operator()(int x) const { return x + 1; }
+};
+
+struct traced_process {
+    atomic_int& _received;
+    void operator()(int) const { ++_received; }
+};
+
+size_t occurrences(const string& text, const string& pattern) {
+    size_t result = 0;
+    for (auto p = text.find(pattern); p != string::npos; p = text.find(pattern, p + 1)) ++result;
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(chrome_trace_contains_the_executed_tasks) {
+    BOOST_TEST_MESSAGE("A chrome trace records the tasks run between start and stop");
+
+    {
+        stlab::priority_task_system system{task_system_options{2, "traced"}};
+
+        // Not recorded.
+        BOOST_REQUIRE_EQUAL(42, blocking_get(async(system.executor(), traced_work{})));
+
+        start_trace();
+
+        for (int n = 0; n != 10; ++n) {
+            BOOST_REQUIRE_EQUAL(42, blocking_get(async(system.high_executor(), traced_work{})));
+        }
+
+        BOOST_REQUIRE_EQUAL(43, blocking_get(async(system.executor(), traced_work{})
+                                                 .then(system.executor(), traced_continuation{})));
+
+        atomic_int received{0};
+        {
+            sender<int> send;
+            receiver<int> receive;
+            tie(send, receive) = channel<int>(system.executor());
+            auto hold = receive | traced_process{received};
+            receive.set_ready();
+            for (int n = 0; n != 5; ++n) send(n);
+            while (received != 5) rest();
+        }
+
+        // A task records itself after its result is delivered, joining the workers waits for it.
+    }
+
+    stop_trace();
+
+    stringstream out;
+    write_chrome_trace(out);
+    auto trace = out.str();
+
+    BOOST_REQUIRE(trace.find("{\"traceEvents\":[") == 0);
+    BOOST_REQUIRE_EQUAL(11u, occurrences(trace, "\"name\":\"(anonymous namespace)::traced_work\""));
+    BOOST_REQUIRE_EQUAL(1u, occurrences(trace, "(anonymous namespace)::traced_continuation"));
+    BOOST_REQUIRE_LE(1u, occurrences(trace, "(anonymous namespace)::traced_process"));
+    BOOST_REQUIRE_LE(10u, occurrences(trace, "\"priority\":\"high\""));
+    BOOST_REQUIRE_LE(1u, occurrences(trace, "\"args\":{\"name\":\"traced 0\"}") +
+                             occurrences(trace, "\"args\":{\"name\":\"traced 1\"}"));
+}
+
+BOOST_AUTO_TEST_CASE(trace_buffers_are_reused_after_their_threads_exit) {
+    BOOST_TEST_MESSAGE("Threads that start after others have exited reuse their trace buffers");
+
+    auto buffers = [] {
+        stringstream out;
+        write_chrome_trace(out);
+        return occurrences(out.str(), "\"name\":\"thread_name\"");
+    };
+
+    start_trace();
+    size_t first = 0;
+    for (int n = 0; n != 3; ++n) {
+        {
+            stlab::priority_task_system system{task_system_options{2, "reused"}};
+            vector<future<int>> results;
+            for (int k = 0; k != 20; ++k) results.push_back(async(system.executor(), traced_work{}));
+            for (auto& e : results) BOOST_REQUIRE_EQUAL(42, blocking_get(e));
+        }
+        if (n == 0) first = buffers();
+        BOOST_REQUIRE_EQUAL(first, buffers());
+    }
+    stop_trace();
+}
+
+#endif